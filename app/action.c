@@ -21,6 +21,9 @@
 	#include "app/fm.h"
 #endif
 #include "app/search.h"
+#ifdef ENABLE_SPECTRUM
+	#include "app/spectrum.h"
+#endif
 #include "audio.h"
 #include "bsp/dp32g030/gpio.h"
 #ifdef ENABLE_FMRADIO
@@ -397,6 +400,29 @@ void ACTION_Scan(bool bRestart)
 	}
 #endif
 
+#ifdef ENABLE_SPECTRUM
+	void ACTION_Spectrum(void)
+	{
+		if (g_current_function == FUNCTION_TRANSMIT)
+			return;
+
+		if (g_current_display_screen == DISPLAY_SPECTRUM)
+		{	// return normal service
+			SPECTRUM_stop();
+			return;
+		}
+
+		APP_stop_scan();
+
+		#ifdef ENABLE_FMRADIO
+			if (g_fm_radio_mode)
+				FM_turn_off();
+		#endif
+
+		SPECTRUM_start();
+	}
+#endif
+
 void ACTION_process(const key_code_t Key, const bool key_pressed, const bool key_held)
 {
 	uint8_t Short = ACTION_OPT_NONE;
@@ -428,6 +454,11 @@ void ACTION_process(const key_code_t Key, const bool key_pressed, const bool key
 			return;
 	}
 
+	#ifdef ENABLE_SPECTRUM
+		if (g_current_display_screen == DISPLAY_SPECTRUM && Short != ACTION_OPT_SPECTRUM)
+			return;   // the radio is busy sweeping
+	#endif
+
 	switch (Short)
 	{
 		default:
@@ -465,5 +496,10 @@ void ACTION_process(const key_code_t Key, const bool key_pressed, const bool key
 				ACTION_AlarmOrTone(true);
 			#endif
 			break;
+		#ifdef ENABLE_SPECTRUM
+			case ACTION_OPT_SPECTRUM:
+				ACTION_Spectrum();
+				break;
+		#endif
 	}
 }
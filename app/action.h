@@ -28,6 +28,9 @@ void ACTION_Scan(bool bFlag);
 #ifdef ENABLE_FMRADIO
 	void ACTION_FM(void);
 #endif
+#ifdef ENABLE_SPECTRUM
+	void ACTION_Spectrum(void);
+#endif
 void ACTION_process(const key_code_t Key, const bool bKeyPressed, const bool bKeyHeld);
 
 #endif
@@ -114,6 +114,12 @@ void AIRCOPY_start_fsk_tx(const int request_block_num)
 	// data
 	if (request_block_num < 0)
 	{
+		#ifdef ENABLE_VFO_JOURNAL
+			SETTINGS_stop_journal();
+		#endif
+		#ifdef ENABLE_EEPROM_CACHE
+			SETTINGS_flush();
+		#endif
 		EEPROM_ReadBuffer(eeprom_addr, &g_fsk_buffer[tx_size], 64);
 //		memcpy(&g_fsk_buffer[tx_size], ((uint8_t *)&g_eeprom) + eeprom_addr, 64);
 		tx_size += 64 / 2;
@@ -593,6 +599,12 @@ void AIRCOPY_process_fsk_rx_10ms(void)
 
 		if (eeprom_addr < sizeof(t_config))		// don't allow writing to the calibration data area
 		{
+			#ifdef ENABLE_VFO_JOURNAL
+				SETTINGS_stop_journal();
+			#endif
+			#ifdef ENABLE_EEPROM_CACHE
+				SETTINGS_flush();   // so they don't later land on top of the received data
+			#endif
 			EEPROM_WriteBuffer8(eeprom_addr, data);   // 8 bytes at a time
 //			memcpy(((uint8_t *)&g_eeprom) + eeprom_addr, data, 8);
 		}
@@ -613,6 +625,9 @@ void AIRCOPY_process_fsk_rx_10ms(void)
 //		SETTINGS_write_eeprom_config();
 
 		#ifdef ENABLE_AIRCOPY_RX_REBOOT
+			#ifdef ENABLE_EEPROM_QUEUE
+				EEPROM_flush();
+			#endif
 			#if defined(ENABLE_OVERLAY)
 				overlay_FLASH_RebootToBootloader();
 			#else
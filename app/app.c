@@ -30,6 +30,9 @@
 #include "app/main.h"
 #include "app/menu.h"
 #include "app/search.h"
+#ifdef ENABLE_SPECTRUM
+	#include "app/spectrum.h"
+#endif
 #include "app/uart.h"
 #include "ARMCM0.h"
 #include "audio.h"
@@ -40,10 +43,16 @@
 	#include "driver/bk1080.h"
 #endif
 #include "driver/bk4819.h"
+#ifdef ENABLE_EEPROM_QUEUE
+	#include "driver/eeprom.h"
+#endif
 #include "driver/gpio.h"
 #include "driver/keyboard.h"
 #include "driver/st7565.h"
 #include "driver/system.h"
+#ifdef ENABLE_FAST_FREQ_SCAN
+	#include "driver/systick.h"
+#endif
 #if defined(ENABLE_UART) && defined(ENABLE_UART_DEBUG)
 	#include "driver/uart.h"
 #endif
@@ -63,6 +72,9 @@
 	#include "panadapter.h"
 #endif
 #include "radio.h"
+#ifdef ENABLE_SLICE_STATS
+	#include "scheduler.h"
+#endif
 #include "settings.h"
 #if defined(ENABLE_OVERLAY)
 	#include "sram-overlay.h"
@@ -293,6 +305,19 @@ enum end_of_rx_mode_e {
 };
 typedef enum end_of_rx_mode_e end_of_rx_mode_t;
 
+// the DCS tail tone check is only done every 40ms
+static bool app_tail_tone_check_due;
+
+static void APP_tail_tone_elimination_done(void)
+{
+	g_flag_tail_tone_elimination_complete = true;
+}
+
+void APP_time_slice_40ms(void)
+{
+	app_tail_tone_check_due = true;
+}
+
 static void APP_process_rx(void)
 {
 	#ifdef ENABLE_PANADAPTER
@@ -337,7 +362,7 @@ static void APP_process_rx(void)
 		goto Skip;
 	}
 
-	if (g_found_ctcss_tick_10ms == 0 && !g_monitor_enabled)
+	if (!SCHEDULER_running(&g_found_ctcss_timer) && !g_monitor_enabled)
 	{
 		#if defined(ENABLE_UART) && defined(ENABLE_UART_DEBUG)
 //			UART_printf("rx code check\n");
@@ -389,7 +414,7 @@ static void APP_process_rx(void)
 					if (!g_found_ctcss)
 					{
 						g_found_ctcss           = true;
-						g_found_ctcss_tick_10ms = 100;   // 1 sec
+						SCHEDULER_start(&g_found_ctcss_timer, 1000 / 10, 0, NULL);
 					}
 
 					if (g_cxcss_tail_found)
@@ -409,7 +434,6 @@ static void APP_process_rx(void)
 					if (!g_found_cdcss)
 					{
 						g_found_cdcss           = true;
-						g_found_cdcss_tick_10ms = 100;   // 1 sec
 					}
 
 					if (g_cxcss_tail_found)
@@ -431,7 +455,7 @@ static void APP_process_rx(void)
 
 	if (!g_end_of_rx_detected_maybe &&
 	     Mode == END_OF_RX_MODE_NONE &&
-	     g_next_time_slice_40ms &&
+	     app_tail_tone_check_due &&
 	     g_eeprom.config.setting.tail_tone_elimination &&
 	    (g_current_code_type == CODE_TYPE_DIGITAL || g_current_code_type == CODE_TYPE_REVERSE_DIGITAL) &&
 	     BK4819_GetCTCType() == 1)
@@ -440,7 +464,7 @@ static void APP_process_rx(void)
 	}
 	else
 	{
-		g_next_time_slice_40ms = false;
+		app_tail_tone_check_due = false;
 	}
 
 Skip:
@@ -466,7 +490,7 @@ Skip:
 				if (!g_monitor_enabled)
 					GPIO_ClearBit(&GPIOC->DATA, GPIOC_PIN_SPEAKER);
 
-				g_tail_tone_elimination_tick_10ms     = 20;   // 200ms
+				SCHEDULER_start(&g_tail_tone_elimination_timer, 200 / 10, 0, APP_tail_tone_elimination_done);
 				g_flag_tail_tone_elimination_complete = false;
 				g_end_of_rx_detected_maybe            = true;
 			}
@@ -711,12 +735,14 @@ void APP_stop_scan(void)
 	g_update_status = true;
 }
 
-void APP_next_freq(void)
-{
-	uint32_t freq = g_tx_vfo->freq_config_rx.frequency;
-
+static uint32_t APP_step_scan_freq(uint32_t freq)
+{	// the next frequency along from 'freq'
 	#ifdef ENABLE_SCAN_IGNORE_LIST
+		unsigned int loops = 0;
+		bool         ignored;
 		do {
+			uint32_t lower;
+			uint32_t upper;
 	#endif
 			freq += g_scan_initial_step_size * g_scan_state_dir;
 
@@ -736,7 +762,105 @@ void APP_next_freq(void)
 			#endif
 
 	#ifdef ENABLE_SCAN_IGNORE_LIST
-		} while (FI_freq_ignored(freq) >= 0);
+			ignored = FI_freq_ignored_range(freq, &lower, &upper);
+			if (ignored)
+			{	// jump to the last step inside the ignored range in one go, the next pass steps out of it
+				const uint32_t span = (g_scan_state_dir == SCAN_STATE_DIR_REVERSE) ? freq - lower : upper - freq;
+				freq += (span / g_scan_initial_step_size) * g_scan_initial_step_size * g_scan_state_dir;
+			}
+
+		} while (ignored && ++loops < 256);   // give up if everything is being ignored
+	#endif
+
+	return freq;
+}
+
+#ifdef ENABLE_FAST_FREQ_SCAN
+	static bool APP_scan_freq_quiet(const uint32_t freq)
+	{	// tune to 'freq' and take a quick look, true if there's nothing there worth stopping for
+		#ifdef ENABLE_SCAN_SETTLE_CAL
+			const unsigned int settle_us = RADIO_settle_us(freq);
+		#endif
+		uint16_t rssi;
+
+		BK4819_set_rf_frequency(freq, true);
+		BK4819_set_rf_filter_path(freq);
+
+		#ifdef ENABLE_SCAN_SETTLE_CAL
+			if (settle_us > 0)
+			{	// we know how long this band takes to settle
+				SYSTICK_Delay250ns(settle_us * 4);
+				rssi = BK4819_GetRSSI();
+			}
+			else
+		#endif
+		{	// give the VCO/PLL time to lock, then wait for the RSSI to stop moving
+			unsigned int i;
+
+			SYSTICK_Delay250ns(fast_scan_lock_250ns);
+			rssi = BK4819_GetRSSI();
+			for (i = 0; i < fast_scan_settle_tries; i++)
+			{
+				const uint16_t prev_rssi = rssi;
+				SYSTICK_Delay250ns(fast_scan_settle_250ns);
+				rssi = BK4819_GetRSSI();
+				if ((rssi > prev_rssi ? rssi - prev_rssi : prev_rssi - rssi) <= 2)
+					break;
+			}
+		}
+
+		if (rssi >= g_tx_vfo->squelch_close_rssi_thresh)
+			return false;
+
+		if (BK4819_GetExNoiceIndicator() <= g_tx_vfo->squelch_open_noise_thresh)
+			return false;
+
+		return true;
+	}
+
+	static unsigned int APP_fast_scan_steps(const uint32_t freq)
+	{	// how many steps we've time to look at this tick
+		#ifdef ENABLE_SCAN_SETTLE_CAL
+			const unsigned int settle_us = RADIO_settle_us(freq);
+			if (settle_us > 0)
+			{
+				const unsigned int steps = fast_scan_budget_us / (settle_us + fast_scan_step_us);
+				return (steps > 0) ? steps : 1;
+			}
+		#else
+			(void)freq;
+		#endif
+		return fast_scan_steps_per_tick;
+	}
+#endif
+
+void APP_next_freq(void)
+{
+	uint32_t freq = APP_step_scan_freq(g_tx_vfo->freq_config_rx.frequency);
+
+	#ifdef ENABLE_FAST_FREQ_SCAN
+		bool quiet = false;
+		bool tuned = false;
+
+		if (g_css_scan_mode == CSS_SCAN_MODE_OFF && !g_monitor_enabled)
+		{	// hop straight over the quiet steps, a few per 10ms tick, and only
+			// stop for the full squelch check on a step that shows some energy
+			const unsigned int max_steps = APP_fast_scan_steps(freq);
+			unsigned int       steps     = 0;
+			#ifdef ENABLE_SLICE_STATS
+				const uint32_t start_us  = SYSTICK_get_us();
+			#endif
+
+			while ((quiet = APP_scan_freq_quiet(freq)) && ++steps < max_steps)
+				freq = APP_step_scan_freq(freq);
+
+			#ifdef ENABLE_SLICE_STATS
+				// the settle waits are busy waits, make them show up
+				SCHEDULER_update_stats(&g_time_slice_stats[2], SYSTICK_get_us() - start_us, fast_scan_budget_us);
+			#endif
+
+			tuned = true;   // the radio is already sat on 'freq'
+		}
 	#endif
 
 	g_tx_vfo->freq_in_channel = 0xff;
@@ -762,11 +886,21 @@ void APP_next_freq(void)
 	#else
 		// don't need to go through all the other stuff .. speed things up !!
 
-		BK4819_set_rf_frequency(g_tx_vfo->freq_config_rx.frequency, true);
-		BK4819_set_rf_filter_path(g_tx_vfo->freq_config_rx.frequency);
+		#ifdef ENABLE_FAST_FREQ_SCAN
+			if (!tuned)
+		#endif
+		{
+			BK4819_set_rf_frequency(g_tx_vfo->freq_config_rx.frequency, true);
+			BK4819_set_rf_filter_path(g_tx_vfo->freq_config_rx.frequency);
+		}
 
 		RADIO_apply_offset(g_tx_vfo, false);
 
+		#ifdef ENABLE_FAST_FREQ_SCAN
+			if (quiet)
+				g_scan_tick_10ms = 1;      // nothing here, carry on at the next tick
+			else
+		#endif
 		#ifdef ENABLE_FASTER_CHANNEL_SCAN
 			//g_scan_tick_10ms = 10;   // 100ms
 			g_scan_tick_10ms = 6;      // 60ms
@@ -1255,9 +1389,9 @@ void APP_end_tx(void)
 		if (g_vox_audio_detected)
 		{
 			if (g_vox_lost)
-				g_vox_stop_tick_10ms = vox_stop_10ms;   // 1 second
+				SCHEDULER_start(&g_vox_stop_timer, vox_stop_10ms, 0, NULL);   // 1 second
 			else
-			if (g_vox_stop_tick_10ms == 0)
+			if (SCHEDULER_remaining(&g_vox_stop_timer) == 0)
 				g_vox_audio_detected = false;
 
 			if (g_current_function == FUNCTION_TRANSMIT && !g_ptt_is_pressed && !g_vox_audio_detected)
@@ -1317,7 +1451,7 @@ void APP_end_tx(void)
 			return;
 
 		#if defined(ENABLE_UART)
-			if (g_serial_config_tick_500ms > 0)
+			if (SCHEDULER_running(&g_serial_config_timer))
 				return;
 		#endif
 
@@ -1362,7 +1496,7 @@ void APP_process_keys(void)
 		if (!g_ptt_is_pressed && g_eeprom.config.setting.tx_enable && g_current_function != FUNCTION_TRANSMIT)
 		{
 		#if defined(ENABLE_UART)
-			if (g_serial_config_tick_500ms == 0)
+			if (!SCHEDULER_running(&g_serial_config_timer))
 		#endif
 			{
 			#ifdef ENABLE_AIRCOPY
@@ -1376,7 +1510,7 @@ void APP_process_keys(void)
 						if (++g_ptt_debounce >= 3)        // 30ms debounce
 						{	// start TX'ing
 
-							g_boot_tick_10ms   = 0;       // cancel the boot-up screen
+							SCHEDULER_stop(&g_boot_timer);   // cancel the boot-up screen
 							g_ptt_is_pressed   = ptt_pressed;
 							g_ptt_was_released = false;
 							g_ptt_debounce     = 3;
@@ -1392,7 +1526,7 @@ void APP_process_keys(void)
 	{	// PTT released
 
 	#if defined(ENABLE_UART)
-		if (g_ptt_is_pressed || g_serial_config_tick_500ms > 0)
+		if (g_ptt_is_pressed || SCHEDULER_running(&g_serial_config_timer))
 	#else
 		if (g_ptt_is_pressed)
 	#endif
@@ -1424,7 +1558,7 @@ void APP_process_keys(void)
 	key = KEYBOARD_Poll();
 
 	#if defined(ENABLE_UART)
-		if (g_serial_config_tick_500ms > 0)
+		if (SCHEDULER_running(&g_serial_config_timer))
 		{	// config upload/download in progress
 			g_key_debounce_press  = 0;
 			g_key_debounce_repeat = 0;
@@ -1449,7 +1583,7 @@ void APP_process_keys(void)
 					g_key_debounce_repeat = 0;
 					g_key_prev            = KEY_INVALID;
 					g_key_held            = false;
-					g_boot_tick_10ms      = 0;   // cancel boot screen/beeps
+					SCHEDULER_stop(&g_boot_timer);   // cancel boot screen/beeps
 					g_update_status       = true;
 //					g_update_display      = true;
 				}
@@ -1608,6 +1742,10 @@ void APP_channel_next(const bool remember_current, const scan_state_dir_t scan_d
 	g_scan_current_scan_list = SCAN_NEXT_CHAN_SCANLIST1;
 	g_scan_state_dir         = scan_direction;
 
+	#ifdef ENABLE_SCAN_REG_IMAGES
+		RADIO_invalidate_images();
+	#endif
+
 	if (remember_current)
 	{
 		g_scan_restore_channel   = 0xff;
@@ -2064,6 +2202,10 @@ void APP_time_slice_500ms(void)
 {
 	bool exit_menu = false;
 
+	#ifdef ENABLE_LCD_PARTIAL_BLIT
+		ST7565_Refresh();   // RF can upset the display settings
+	#endif
+
 	if (g_key_input_count_down > 0)
 	{
 		if (--g_key_input_count_down == 0)
@@ -2073,7 +2215,7 @@ void APP_time_slice_500ms(void)
 			if (g_beep_to_play != BEEP_NONE)
 			{
 			#if defined(ENABLE_UART)
-				if (g_serial_config_tick_500ms == 0)
+				if (!SCHEDULER_running(&g_serial_config_timer))
 			#endif
 					AUDIO_PlayBeep(g_beep_to_play);
 				g_beep_to_play = BEEP_NONE;
@@ -2096,7 +2238,7 @@ void APP_time_slice_500ms(void)
 			g_update_display = true;
 
 	#if defined(ENABLE_UART)
-		if (g_serial_config_tick_500ms > 0)
+		if (SCHEDULER_running(&g_serial_config_timer))
 			return;
 	#endif
 
@@ -2104,10 +2246,12 @@ void APP_time_slice_500ms(void)
 
 	if (g_current_function == FUNCTION_TRANSMIT)
 	{
-		if (g_tx_timer_tick_500ms <= 7)
+		const unsigned int tx_left_500ms = (SCHEDULER_remaining(&g_tx_timer) + 49) / 50;
+
+		if (tx_left_500ms <= 7)
 		{	// <= 3 seconds TX time left .. start beeping
 
-			if (g_tx_timer_tick_500ms & 1u)
+			if (tx_left_500ms & 1u)
 			{
 				if (!tx_timeout_tone_on)
 				{
@@ -2126,7 +2270,7 @@ void APP_time_slice_500ms(void)
 			}
 		}
 
-		if (g_tx_timer_tick_500ms & 1u)
+		if (tx_left_500ms & 1u)
 			g_update_display = true;
 	}
 	else
@@ -2202,6 +2346,12 @@ void APP_time_slice_500ms(void)
 
 		if (g_usb_current > 500 || g_eeprom.calib.battery[3] < g_usb_current_voltage)
 		{
+			#ifdef ENABLE_EEPROM_CACHE
+				SETTINGS_flush();
+			#endif
+			#ifdef ENABLE_EEPROM_QUEUE
+				EEPROM_flush();
+			#endif
 			#ifdef ENABLE_OVERLAY
 				overlay_FLASH_RebootToBootloader();
 			#else
@@ -2464,6 +2614,19 @@ void APP_time_slice_10ms(void)
 {
 	g_flash_light_blink_tick_10ms++;
 
+	#ifdef ENABLE_EEPROM_LAZY_LOAD
+		// before starting the next queued write, so the read isn't stuck waiting for it
+		SETTINGS_load_next();
+	#endif
+
+	#ifdef ENABLE_EEPROM_QUEUE
+		EEPROM_process();
+	#endif
+
+	#ifdef ENABLE_UART_TELEMETRY
+		UART_telemetry_drain();
+	#endif
+
 	if (g_backlight_tick_10ms > 0 &&
 	   !g_ask_to_save &&
 	    g_css_scan_mode == CSS_SCAN_MODE_OFF &&
@@ -2537,10 +2700,14 @@ void APP_time_slice_10ms(void)
 			UART_HandleCommand();
 			__enable_irq();
 		}
+		#ifdef ENABLE_UART_BULK_EEPROM
+			else
+				UART_process_bulk();   // keep a bulk read going
+		#endif
 	#endif
 
 #if defined(ENABLE_UART)
-	if (g_current_function == FUNCTION_TRANSMIT && (g_tx_timeout_reached || g_serial_config_tick_500ms > 0))
+	if (g_current_function == FUNCTION_TRANSMIT && (g_tx_timeout_reached || SCHEDULER_running(&g_serial_config_timer)))
 #else
 	if (g_current_function == FUNCTION_TRANSMIT && g_tx_timeout_reached)
 #endif
@@ -2561,7 +2728,7 @@ void APP_time_slice_10ms(void)
 	}
 
 	#ifdef ENABLE_UART
-		if (g_serial_config_tick_500ms > 0)
+		if (SCHEDULER_running(&g_serial_config_timer))
 			return;
 	#endif
 
@@ -2582,7 +2749,7 @@ void APP_time_slice_10ms(void)
 	#endif
 
 #if defined(ENABLE_UART)
-	if (g_reduced_service || g_serial_config_tick_500ms > 0)
+	if (g_reduced_service || SCHEDULER_running(&g_serial_config_timer))
 #else
 	if (g_reduced_service)
 #endif
@@ -2593,11 +2760,23 @@ void APP_time_slice_10ms(void)
 		return;
 	}
 
+	#ifdef ENABLE_SPECTRUM
+		if (g_current_display_screen == DISPLAY_SPECTRUM)
+		{	// we're in spectrum mode, the radio is all ours
+			SPECTRUM_process_10ms();
+			APP_process_keys();
+			return;
+		}
+	#endif
+
 	// ***************************************************
 
 	#ifdef ENABLE_BOOT_BEEPS
-		if (g_boot_tick_10ms > 0 && (g_boot_tick_10ms % 25) == 0)
+	{
+		const uint32_t boot_left = SCHEDULER_remaining(&g_boot_timer);
+		if (boot_left > 0 && (boot_left % 25) == 0)
 			AUDIO_PlayBeep(BEEP_880HZ_40MS_OPTIONAL);
+	}
 	#endif
 
 #ifdef ENABLE_PANADAPTER
@@ -2993,6 +3172,12 @@ static void APP_process_key(const key_code_t Key, const bool key_pressed, const
 						break;
 				#endif
 
+				#ifdef ENABLE_SPECTRUM
+					case DISPLAY_SPECTRUM:
+						SPECTRUM_process_key(Key, key_pressed, key_held);
+						break;
+				#endif
+
 				case DISPLAY_INVALID:
 				default:
 					break;
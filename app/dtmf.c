@@ -107,6 +107,9 @@ bool DTMF_ValidateCodes(char *pCode, const unsigned int size)
 		int i = -1;
 		if (Index >= 0 && Index < (int)ARRAY_SIZE(g_eeprom.config.dtmf_contact))
 		{
+			#ifdef ENABLE_EEPROM_LAZY_LOAD
+				SETTINGS_load((unsigned int)(((uint8_t *)&g_eeprom.config.dtmf_contact[Index]) - ((uint8_t *)&g_eeprom)), 16);
+			#endif
 			memcpy(pContact, &g_eeprom.config.dtmf_contact[Index], 16);
 	//		EEPROM_ReadBuffer(0x1C00 + (Index * 16), pContact, 16);
 			i = (int)pContact[0] - ' ';
@@ -100,7 +100,7 @@ void GENERIC_Key_PTT(bool key_pressed)
 	g_input_box_index = 0;
 
 #if defined(ENABLE_UART)
-	if (!key_pressed || g_serial_config_tick_500ms > 0)
+	if (!key_pressed || SCHEDULER_running(&g_serial_config_timer))
 #else
 	if (!key_pressed)
 #endif
@@ -126,8 +126,6 @@ void toggle_chan_scanlist(void)
 			g_tx_vfo->channel_attributes.scanlist1 = 1;
 	}
 
-	g_eeprom.config.channel_attributes[g_tx_vfo->channel_save] = g_tx_vfo->channel_attributes;
-
 	SETTINGS_save_chan_attribs_name(g_tx_vfo->channel_save, g_tx_vfo);
 
 	g_vfo_configure_mode = VFO_CONFIGURE;
@@ -392,7 +390,21 @@ void processFKeyFunction(const key_code_t Key)
 				if (g_fkey_pressed)
 				{
 					g_fkey_pressed = false;
-					g_eeprom.config.setting.panadapter = (g_eeprom.config.setting.panadapter + 1) & 1u;
+					#ifdef ENABLE_PANADAPTER_WATERFALL
+						// off -> trace -> waterfall -> off
+						if (!g_eeprom.config.setting.panadapter)
+						{
+							g_eeprom.config.setting.panadapter            = 1;
+							g_eeprom.config.setting.panadapter_trace_only = 1;
+						}
+						else
+						if (g_eeprom.config.setting.panadapter_trace_only)
+							g_eeprom.config.setting.panadapter_trace_only = 0;
+						else
+							g_eeprom.config.setting.panadapter = 0;
+					#else
+						g_eeprom.config.setting.panadapter = (g_eeprom.config.setting.panadapter + 1) & 1u;
+					#endif
 					g_request_save_settings = true;
 					break;
 				}
@@ -230,10 +230,25 @@ int MENU_GetLimits(uint8_t Cursor, int32_t *pMin, int32_t *pMax)
 				break;
 		#endif
 
+		#ifdef ENABLE_PANADAPTER_WATERFALL
+			case MENU_PANADAPTER:
+				*pMin = 0;
+				*pMax = ARRAY_SIZE(g_sub_menu_panadapter) - 1;
+				break;
+		#endif
+
+		#ifdef ENABLE_PANADAPTER_SPAN
+			case MENU_PANADAPTER_SPAN:
+			case MENU_PANADAPTER_BIN:
+				*pMin = 0;
+				*pMax = PANADAPTER_SPAN_AUTO;   // 0 = auto
+				break;
+		#endif
+
 		#ifdef ENABLE_AM_FIX
 //			case MENU_AM_FIX:
 		#endif
-		#ifdef ENABLE_PANADAPTER
+		#if defined(ENABLE_PANADAPTER) && !defined(ENABLE_PANADAPTER_WATERFALL)
 			case MENU_PANADAPTER:
 		#endif
 		#ifdef ENABLE_TX_AUDIO_BAR
@@ -399,6 +414,13 @@ int MENU_GetLimits(uint8_t Cursor, int32_t *pMin, int32_t *pMax)
 				break;
 		#endif
 
+		#ifdef ENABLE_SCAN_SETTLE_CAL
+			case MENU_SCAN_CAL:
+				*pMin = 0;
+				*pMax = ARRAY_SIZE(g_eeprom.calib.scan_settle_50us) - 1;
+				break;
+		#endif
+
 		case MENU_BAT_CAL:
 			*pMin = 1600;  // 0
 			*pMax = 2200;  // 2300
@@ -572,6 +594,10 @@ void MENU_AcceptSetting(void)
 				t_channel_name    *chan_name = &g_eeprom.config.channel_name[chan];
 				int                i;
 
+				#ifdef ENABLE_EEPROM_LAZY_LOAD
+					SETTINGS_load_channel(chan);
+				#endif
+
 				// trailing trim
 				for (i = 9; i >= 0; i--)
 				{
@@ -711,7 +737,24 @@ void MENU_AcceptSetting(void)
 
 		#ifdef ENABLE_PANADAPTER
 			case MENU_PANADAPTER:
-				g_eeprom.config.setting.panadapter = g_sub_menu_selection;
+				#ifdef ENABLE_PANADAPTER_WATERFALL
+					g_eeprom.config.setting.panadapter            = (g_sub_menu_selection > 0) ? 1 : 0;
+					g_eeprom.config.setting.panadapter_trace_only = (g_sub_menu_selection < 2) ? 1 : 0;
+				#else
+					g_eeprom.config.setting.panadapter = g_sub_menu_selection;
+				#endif
+				break;
+		#endif
+
+		#ifdef ENABLE_PANADAPTER_SPAN
+			case MENU_PANADAPTER_SPAN:
+				g_eeprom.config.setting.panadapter_span    = (g_sub_menu_selection == 0) ? PANADAPTER_SPAN_AUTO : g_sub_menu_selection - 1;
+				PAN_restart(true);
+				break;
+
+			case MENU_PANADAPTER_BIN:
+				g_eeprom.config.setting.panadapter_spacing = (g_sub_menu_selection == 0) ? PANADAPTER_SPAN_AUTO : g_sub_menu_selection - 1;
+				PAN_restart(true);
 				break;
 		#endif
 
@@ -973,6 +1016,30 @@ void MENU_AcceptSetting(void)
 				return;
 		#endif
 
+		#ifdef ENABLE_SCAN_SETTLE_CAL
+			case MENU_SCAN_CAL:
+				{	// about a second in all, so show each band as it's measured
+					const unsigned int selected = g_sub_menu_selection;
+					unsigned int       band;
+
+					for (band = 0; band < ARRAY_SIZE(g_eeprom.calib.scan_settle_50us); band++)
+					{
+						g_sub_menu_selection = band;
+						g_eeprom.calib.scan_settle_50us[band] = 0xff;   // "--" until it's done
+						UI_DisplayMenu();
+						#ifdef ENABLE_LCD_ASYNC_BLIT
+							ST7565_Flush();
+						#endif
+
+						RADIO_calibrate_settle(band);
+					}
+
+					g_sub_menu_selection = selected;
+					RADIO_save_settle();
+				}
+				break;
+		#endif
+
 		case MENU_BAT_CAL:
 		{
 			g_eeprom.calib.battery[0] = (520ul * g_sub_menu_selection) / 760;  // 5.20V empty, blinking above this value, reduced functionality below
@@ -1238,7 +1305,21 @@ void MENU_ShowCurrentSetting(void)
 
 		#ifdef ENABLE_PANADAPTER
 			case MENU_PANADAPTER:
-				g_sub_menu_selection = g_eeprom.config.setting.panadapter;
+				#ifdef ENABLE_PANADAPTER_WATERFALL
+					g_sub_menu_selection = !g_eeprom.config.setting.panadapter ? 0 : g_eeprom.config.setting.panadapter_trace_only ? 1 : 2;
+				#else
+					g_sub_menu_selection = g_eeprom.config.setting.panadapter;
+				#endif
+				break;
+		#endif
+
+		#ifdef ENABLE_PANADAPTER_SPAN
+			case MENU_PANADAPTER_SPAN:
+				g_sub_menu_selection = (g_eeprom.config.setting.panadapter_span    >= PANADAPTER_SPAN_AUTO) ? 0 : g_eeprom.config.setting.panadapter_span    + 1;
+				break;
+
+			case MENU_PANADAPTER_BIN:
+				g_sub_menu_selection = (g_eeprom.config.setting.panadapter_spacing >= PANADAPTER_SPAN_AUTO) ? 0 : g_eeprom.config.setting.panadapter_spacing + 1;
 				break;
 		#endif
 
@@ -1476,6 +1557,12 @@ void MENU_ShowCurrentSetting(void)
 				break;
 		#endif
 
+		#ifdef ENABLE_SCAN_SETTLE_CAL
+			case MENU_SCAN_CAL:
+				g_sub_menu_selection = FREQUENCY_GetBand(g_current_vfo->p_rx->frequency);
+				break;
+		#endif
+
 		case MENU_BAT_CAL:
 			g_sub_menu_selection = g_eeprom.calib.battery[3];
 			break;
@@ -1893,6 +1980,12 @@ static void MENU_Key_MENU(const bool key_pressed, const bool key_held)
 
 						MENU_AcceptSetting();
 
+						#ifdef ENABLE_EEPROM_CACHE
+							SETTINGS_flush();
+						#endif
+						#ifdef ENABLE_EEPROM_QUEUE
+							EEPROM_flush();
+						#endif
 						#if defined(ENABLE_OVERLAY)
 							overlay_FLASH_RebootToBootloader();
 						#else
@@ -0,0 +1,329 @@
+/* Copyright 2023 One of Eleven
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <string.h>
+
+#include "app/spectrum.h"
+#include "audio.h"
+#include "driver/bk4819.h"
+#include "driver/systick.h"
+#include "frequencies.h"
+#include "functions.h"
+#include "misc.h"
+#include "radio.h"
+#include "ui/inputbox.h"
+#include "ui/ui.h"
+
+// a full screen sweep between any two frequencies
+//
+// unlike the panadapter it doesn't stop on the VFO frequency or share the radio with normal RX, it
+// just sweeps the points as fast as the PLL/RSSI settle time allows, spending most of each 10ms tick
+// doing it .. the radio isn't listening while the spectrum screen is showing
+
+uint32_t        g_spectrum_start;
+uint32_t        g_spectrum_step;
+uint8_t         g_spectrum_rssi[SPECTRUM_POINTS];
+bool            g_spectrum_valid;
+unsigned int    g_spectrum_marker = SPECTRUM_POINTS / 2;
+unsigned int    g_spectrum_peak;
+unsigned int    g_spectrum_sweeps_10;
+spectrum_rbw_t  g_spectrum_rbw;
+spectrum_edit_t g_spectrum_edit;
+
+static unsigned int spectrum_point;       // next point to sample
+static uint32_t     spectrum_sweep_us;    // when the last sweep finished
+static uint32_t     spectrum_new_start;   // entered start frequency, waiting on the stop frequency
+
+static const uint8_t spectrum_min_rssi = (-147 + 160) * 2;  // -147dBm (S0) min RSSI value
+
+static bool SPECTRUM_in_gap(const uint32_t freq)
+{	// the BK4819 can't tune between its two bands
+	return (freq >= BX4819_BAND1.upper && freq < BX4819_BAND2.lower) ? true : false;
+}
+
+uint32_t SPECTRUM_freq(const unsigned int point)
+{
+	return g_spectrum_start + (g_spectrum_step * point);
+}
+
+BK4819_filter_bandwidth_t SPECTRUM_filter_bandwidth(void)
+{
+	switch (g_spectrum_rbw)
+	{
+		case SPECTRUM_RBW_25K:  return BK4819_FILTER_BW_WIDE;
+		case SPECTRUM_RBW_12K5: return BK4819_FILTER_BW_NARROW;
+		case SPECTRUM_RBW_6K25: return BK4819_FILTER_BW_NARROWER;
+		default:                break;
+	}
+
+	// auto .. the narrowest filter that still covers the gap between points
+	return (g_spectrum_step <= 625) ? BK4819_FILTER_BW_NARROWER : (g_spectrum_step <= 1250) ? BK4819_FILTER_BW_NARROW : BK4819_FILTER_BW_WIDE;
+}
+
+static void SPECTRUM_restart(void)
+{	// throw away the sweep in progress and start again from the bottom
+	spectrum_point       = 0;
+	g_spectrum_valid     = false;
+	g_spectrum_sweeps_10 = 0;
+	g_update_display     = true;
+}
+
+static void SPECTRUM_set_range(int32_t start, uint32_t step)
+{	// keep the whole sweep inside the radio's frequency range
+
+	const uint32_t lower    = FREQ_BAND_TABLE[0].lower;
+	const uint32_t upper    = FREQ_BAND_TABLE[ARRAY_SIZE(FREQ_BAND_TABLE) - 1].upper;
+	const uint32_t max_step = (upper - lower) / (SPECTRUM_POINTS - 1);
+
+	step = (step < SPECTRUM_MIN_STEP) ? SPECTRUM_MIN_STEP : (step > max_step) ? max_step : step;
+
+	if (start > (int32_t)(upper - (step * (SPECTRUM_POINTS - 1))))
+		start = upper - (step * (SPECTRUM_POINTS - 1));
+	if (start < (int32_t)lower)
+		start = lower;
+
+	g_spectrum_start = start;
+	g_spectrum_step  = step;
+
+	SPECTRUM_restart();
+}
+
+static void SPECTRUM_zoom(const uint32_t step)
+{	// change the point spacing, keeping the marker on the same frequency
+	const int32_t freq = (int32_t)SPECTRUM_freq(g_spectrum_marker);
+	SPECTRUM_set_range(freq - (int32_t)(step * g_spectrum_marker), step);
+}
+
+void SPECTRUM_start(void)
+{
+	g_monitor_enabled = false;
+	g_squelch_open    = false;
+
+	RADIO_select_vfos();
+	RADIO_setup_registers(true);
+
+	if (g_spectrum_step == 0)
+	{	// first time in, center it on the VFO
+		g_spectrum_marker = SPECTRUM_POINTS / 2;
+		SPECTRUM_set_range((int32_t)g_rx_vfo->p_rx->frequency - (int32_t)(SPECTRUM_DEF_STEP * g_spectrum_marker), SPECTRUM_DEF_STEP);
+	}
+	else
+	{
+		SPECTRUM_restart();
+	}
+
+	g_spectrum_edit   = SPECTRUM_EDIT_NONE;
+	g_input_box_index = 0;
+
+	g_request_display_screen = DISPLAY_SPECTRUM;
+}
+
+void SPECTRUM_stop(void)
+{	// return normal service
+	g_spectrum_edit   = SPECTRUM_EDIT_NONE;
+	g_input_box_index = 0;
+
+	g_flag_reconfigure_vfos  = true;
+	g_request_display_screen = DISPLAY_MAIN;
+}
+
+static void SPECTRUM_sweep_done(void)
+{
+	const uint32_t now_us = SYSTICK_get_us();
+	unsigned int   i;
+
+	g_spectrum_peak = 0;
+	for (i = 1; i < SPECTRUM_POINTS; i++)
+		if (g_spectrum_rssi[i] > g_spectrum_rssi[g_spectrum_peak])
+			g_spectrum_peak = i;
+
+	// the rate is timed from the end of one full sweep to the next
+	if (g_spectrum_valid && now_us != spectrum_sweep_us)
+		g_spectrum_sweeps_10 = 10000000u / (now_us - spectrum_sweep_us);
+
+	spectrum_sweep_us = now_us;
+	spectrum_point    = 0;
+	g_spectrum_valid  = true;
+	g_update_display  = true;
+}
+
+void SPECTRUM_process_10ms(void)
+{
+	const uint32_t tick_us = SYSTICK_get_us();
+
+	do {
+		const uint32_t freq = SPECTRUM_freq(spectrum_point);
+		uint16_t       rssi = 0;
+
+		if (spectrum_point == 0)
+			BK4819_SetFilterBandwidth(SPECTRUM_filter_bandwidth());
+
+		if (!SPECTRUM_in_gap(freq))
+		{
+			unsigned int settle_us = spectrum_settle_us;
+
+			if (spectrum_point == 0 || SPECTRUM_in_gap(SPECTRUM_freq(spectrum_point - 1)))
+			{	// a big jump (back to the start, or over the gap between the bands) takes longer to settle
+				settle_us *= 4;
+				#ifdef ENABLE_SCAN_SETTLE_CAL
+					if (RADIO_settle_us(freq) > 0)
+						settle_us = RADIO_settle_us(freq);   // we know how long this band takes
+				#endif
+			}
+
+			BK4819_set_rf_frequency(freq, true);
+			BK4819_set_rf_filter_path(freq);
+
+			SYSTICK_Delay250ns(settle_us * 4);
+
+			rssi = BK4819_GetRSSI();
+		}
+
+		g_spectrum_rssi[spectrum_point] = (rssi > 255) ? 255 : (rssi < spectrum_min_rssi) ? spectrum_min_rssi : rssi;
+
+		if (++spectrum_point >= SPECTRUM_POINTS)
+		{	// completed a full sweep, let the screen show it before starting the next one
+			SPECTRUM_sweep_done();
+			return;
+		}
+
+	} while ((SYSTICK_get_us() - tick_us) < spectrum_budget_us);
+}
+
+static void SPECTRUM_key_edit(const key_code_t key)
+{	// start and stop frequency entry
+	uint32_t freq;
+
+	if (key == KEY_EXIT)
+	{
+		if (g_input_box_index > 0)
+			g_input_box[--g_input_box_index] = 10;   // delete the last digit
+		else
+			g_spectrum_edit = SPECTRUM_EDIT_NONE;    // cancel
+		return;
+	}
+
+	if (key != KEY_MENU)
+	{
+		if (key > KEY_9)
+		{
+			g_beep_to_play = BEEP_500HZ_60MS_DOUBLE_BEEP_OPTIONAL;
+			return;
+		}
+		INPUTBOX_append(key);
+		return;
+	}
+
+	// no digits keeps the current frequency
+	if (g_spectrum_edit == SPECTRUM_EDIT_START)
+		freq = g_spectrum_start;
+	else
+		freq = SPECTRUM_freq(SPECTRUM_POINTS - 1);
+	if (g_input_box_index > 0)
+		NUMBER_Get(g_input_box, &freq);
+
+	g_input_box_index = 0;
+
+	if (g_spectrum_edit == SPECTRUM_EDIT_START)
+	{	// now the stop frequency
+		spectrum_new_start = freq;
+		g_spectrum_edit    = SPECTRUM_EDIT_STOP;
+		return;
+	}
+
+	g_spectrum_edit = SPECTRUM_EDIT_NONE;
+
+	if (freq < spectrum_new_start)
+	{	// they're the wrong way round
+		const uint32_t tmp = freq;
+		freq               = spectrum_new_start;
+		spectrum_new_start = tmp;
+	}
+
+	SPECTRUM_set_range(spectrum_new_start, (freq - spectrum_new_start) / (SPECTRUM_POINTS - 1));
+}
+
+void SPECTRUM_process_key(key_code_t key, bool key_pressed, bool key_held)
+{
+	if (key == KEY_UP || key == KEY_DOWN)
+	{	// move the marker, keeps going while held
+		if (!key_pressed || g_spectrum_edit != SPECTRUM_EDIT_NONE)
+			return;
+
+		if (key == KEY_UP && g_spectrum_marker < (SPECTRUM_POINTS - 1))
+			g_spectrum_marker++;
+		else
+		if (key == KEY_DOWN && g_spectrum_marker > 0)
+			g_spectrum_marker--;
+
+		g_update_display = true;
+		return;
+	}
+
+	if (!key_pressed || key_held || key == KEY_PTT)
+		return;
+
+	g_beep_to_play   = BEEP_1KHZ_60MS_OPTIONAL;
+	g_update_display = true;
+
+	if (g_spectrum_edit != SPECTRUM_EDIT_NONE)
+	{
+		SPECTRUM_key_edit(key);
+		return;
+	}
+
+	switch (key)
+	{
+		case KEY_1:   // zoom out
+			SPECTRUM_zoom(g_spectrum_step * 2);
+			break;
+
+		case KEY_7:   // zoom in
+			SPECTRUM_zoom(g_spectrum_step / 2);
+			break;
+
+		case KEY_4:   // down half a screen
+			SPECTRUM_set_range((int32_t)g_spectrum_start - (int32_t)(g_spectrum_step * (SPECTRUM_POINTS / 2)), g_spectrum_step);
+			break;
+
+		case KEY_6:   // up half a screen
+			SPECTRUM_set_range(g_spectrum_start + (g_spectrum_step * (SPECTRUM_POINTS / 2)), g_spectrum_step);
+			break;
+
+		case KEY_0:   // next RX filter bandwidth
+			g_spectrum_rbw = (g_spectrum_rbw + 1) % SPECTRUM_RBW_LEN;
+			SPECTRUM_restart();
+			break;
+
+		case KEY_STAR:   // marker to the peak
+			if (g_spectrum_valid)
+				g_spectrum_marker = g_spectrum_peak;
+			break;
+
+		case KEY_MENU:   // enter new start/stop frequencies
+			g_spectrum_edit   = SPECTRUM_EDIT_START;
+			g_input_box_index = 0;
+			break;
+
+		case KEY_EXIT:
+			SPECTRUM_stop();
+			break;
+
+		default:
+			g_beep_to_play = BEEP_500HZ_60MS_DOUBLE_BEEP_OPTIONAL;
+			break;
+	}
+}
@@ -0,0 +1,68 @@
+/* Copyright 2023 One of Eleven
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef APP_SPECTRUM_H
+#define APP_SPECTRUM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "driver/bk4819.h"
+#include "driver/keyboard.h"
+#include "driver/st7565.h"
+
+// one sweep point per LCD column
+#define SPECTRUM_POINTS     LCD_WIDTH
+
+#define SPECTRUM_MIN_STEP   10      // 100Hz
+#define SPECTRUM_DEF_STEP   2000    // 20kHz
+
+enum spectrum_rbw_e
+{
+	SPECTRUM_RBW_AUTO = 0,          // follows the point spacing
+	SPECTRUM_RBW_25K,
+	SPECTRUM_RBW_12K5,
+	SPECTRUM_RBW_6K25,
+	SPECTRUM_RBW_LEN
+};
+typedef enum spectrum_rbw_e spectrum_rbw_t;
+
+enum spectrum_edit_e
+{
+	SPECTRUM_EDIT_NONE = 0,
+	SPECTRUM_EDIT_START,            // entering the start frequency
+	SPECTRUM_EDIT_STOP              // entering the stop frequency
+};
+typedef enum spectrum_edit_e spectrum_edit_t;
+
+extern uint32_t        g_spectrum_start;         // 10Hz units
+extern uint32_t        g_spectrum_step;          // 10Hz units between points
+extern uint8_t         g_spectrum_rssi[SPECTRUM_POINTS];
+extern bool            g_spectrum_valid;         // a full sweep has been done
+extern unsigned int    g_spectrum_marker;        // marker point
+extern unsigned int    g_spectrum_peak;          // highest point of the last sweep
+extern unsigned int    g_spectrum_sweeps_10;     // sweeps per second x 10
+extern spectrum_rbw_t  g_spectrum_rbw;
+extern spectrum_edit_t g_spectrum_edit;
+
+uint32_t                  SPECTRUM_freq(const unsigned int point);
+BK4819_filter_bandwidth_t SPECTRUM_filter_bandwidth(void);
+void                      SPECTRUM_start(void);
+void                      SPECTRUM_stop(void);
+void                      SPECTRUM_process_10ms(void);
+void                      SPECTRUM_process_key(key_code_t key, bool key_pressed, bool key_held);
+
+#endif
@@ -31,12 +31,21 @@
 #include "driver/crc.h"
 #include "driver/eeprom.h"
 #include "driver/gpio.h"
+#ifdef ENABLE_SLICE_STATS
+	#include "driver/systick.h"
+#endif
 #if defined(ENABLE_UART)
 	#include "driver/uart.h"
 #endif
 #include "functions.h"
 #include "misc.h"
+#ifdef ENABLE_PANADAPTER
+	#include "panadapter.h"
+#endif
 #include "radio.h"
+#ifdef ENABLE_UART_TELEMETRY
+	#include "scheduler.h"
+#endif
 #include "settings.h"
 #if defined(ENABLE_OVERLAY)
 	#include "sram-overlay.h"
@@ -146,6 +155,102 @@ typedef struct {
 	uint32_t time_stamp;
 } __attribute__((packed)) cmd_052F_t;
 
+#ifdef ENABLE_UART_BULK_EEPROM
+	// bulk eeprom read .. the radio streams the range out in 0x0534 packets, keeping
+	// up to 'window' packets ahead of what the PC has acknowledged with 0x0535
+	typedef struct {
+		Header_t Header;
+		uint16_t Offset;
+		uint16_t Size;        // 0 = stop any read in progress
+		uint8_t  block;       // bytes per packet, 0 = 128
+		uint8_t  window;      // packets allowed in flight, 0 = 1
+		uint8_t  pad[2];
+	} __attribute__((packed)) cmd_0533_t;
+
+	typedef reply_051B_t reply_0534_t;
+
+	typedef struct {
+		Header_t Header;
+		uint16_t Offset;      // the PC has everything below this
+		uint8_t  resend;      // 1 = something went missing, go back and send again from 'Offset'
+		uint8_t  pad;
+	} __attribute__((packed)) cmd_0535_t;
+
+	// bulk eeprom write .. the PC streams the range in 0x0537 packets without waiting for each one
+	// to be acknowledged, every packet gets a 0x0538 reply saying where the next one has to start
+	// (a packet that doesn't start there is dropped, so the PC just goes back to it)
+	typedef struct {
+		Header_t Header;
+		uint16_t Offset;
+		uint8_t  Size;             // multiple of 8
+		uint8_t  allow_password;
+		uint8_t  first;            // 1 = first packet of the stream
+		uint8_t  pad[3];
+//		uint8_t  Data[0];
+	} __attribute__((packed)) cmd_0537_t;
+
+	typedef struct {
+		Header_t Header;
+		struct {
+			uint16_t Offset;       // next packet must start here
+			uint8_t  pad[2];
+		} __attribute__((packed)) Data;
+	} __attribute__((packed)) reply_0538_t;
+#endif
+
+#ifdef ENABLE_UART_TELEMETRY
+	// telemetry subscribe .. the radio streams RSSI/noise/glitch samples in 0x053A packets until
+	// told to stop, or until 'seconds' runs out (the PC renews it to keep it going)
+	typedef struct {
+		Header_t Header;
+		uint16_t period_10ms;   // sample every so many 10ms ticks, 0 = stop
+		uint16_t seconds;       // stop after this long unless it's renewed, 0 = stop
+	} __attribute__((packed)) cmd_0539_t;
+
+	typedef struct {
+		uint16_t tick_10ms;     // low 16 bits of the 10ms tick count
+		uint16_t rssi;          // bits 0-8 = RSSI, bit 15 = squelch open
+		uint8_t  noise;         // ex-noise indicator
+		uint8_t  glitch;        // glitch indicator
+	} __attribute__((packed)) telemetry_sample_t;
+
+	#define TELEMETRY_SAMPLES   8   // most a packet holds
+
+	typedef struct {
+		Header_t Header;
+		struct {
+			uint32_t           frequency;   // the samples were all taken on this frequency
+			uint8_t            lost;        // samples dropped since the last packet (stops at 255)
+			uint8_t            count;
+			uint8_t            pad[2];
+			telemetry_sample_t sample[TELEMETRY_SAMPLES];
+		} __attribute__((packed)) Data;
+	} __attribute__((packed)) reply_053A_t;
+#endif
+
+#ifdef ENABLE_SLICE_STATS
+	// time slice stats
+	typedef struct {
+		Header_t Header;
+		uint8_t  clear;       // 1 = reset the stats after sending them
+		uint8_t  pad[3];
+	} __attribute__((packed)) cmd_0531_t;
+
+	typedef struct {
+		Header_t Header;
+		struct {
+			uint32_t      time_us;      // time stamp
+			sched_stats_t slice[3];     // 10ms time slice, 500ms time slice, fast frequency scan busy waits
+			uint32_t      boot_rx_us;   // power-on to the receiver being set up
+			uint32_t      loaded_us;    // power-on to all of the eeprom being read in, 0 = still going
+			#ifdef ENABLE_BK4819_REG_CACHE
+				uint32_t  reg_hits;     // BK4819 register writes skipped as the chip already had the value
+				uint32_t  reg_misses;   // BK4819 register writes sent
+			#endif
+		} __attribute__((packed)) Data;
+	} __attribute__((packed)) reply_0531_t;
+#endif
+
 static union
 {
 	uint8_t Buffer[256];
@@ -156,8 +261,35 @@ static union
 	} __attribute__((packed));
 } __attribute__((packed)) UART_Command;
 
+#ifdef ENABLE_UART_RX_PARSER
+	// packets are picked out of the DMA ring as the bytes arrive, de-obfuscated and CRC'd as they
+	// go, then copied into UART_Command to be handled .. a handler that takes a while (writing the
+	// eeprom) can be lapped by the next packets arriving in the ring
+
+	typedef enum {
+		RX_HUNT = 0,     // looking for 0xAB
+		RX_START,        // 0xCD
+		RX_SIZE_LO,
+		RX_SIZE_HI,
+		RX_PAYLOAD,      // payload then CRC
+		RX_FOOTER_DC,
+		RX_FOOTER_BA
+	} rx_state_t;
+
+	static struct {
+		rx_state_t state;
+		uint16_t   index;   // next ring byte to look at
+		uint16_t   start;   // ring index of the payload
+		uint16_t   size;    // payload size
+		uint16_t   count;   // payload + CRC bytes so far
+		uint16_t   crc;
+	} rx;
+#endif
+
 uint32_t time_stamp    = 0;
-uint16_t write_index   = 0;
+#ifndef ENABLE_UART_RX_PARSER
+	uint16_t write_index   = 0;
+#endif
 bool     is_encrypted  = true;
 
 #ifdef INCLUDE_AES
@@ -165,13 +297,42 @@ bool     is_encrypted  = true;
 	uint8_t  try_count = 0;
 #endif
 
+#ifdef ENABLE_UART_BULK_EEPROM
+	#define BULK_BLOCK_SIZE     128           // most a 0x0534 packet can hold
+	#define BULK_RESEND_10ms    (500 / 10)    // nothing acknowledged for this long, send it again
+	#define BULK_RESENDS        6             // then give up
+
+	static struct {
+		uint16_t sent;        // next byte to send
+		uint16_t acked;       // the PC has everything below this
+		uint16_t end;
+		uint8_t  block;
+		uint8_t  window;
+		uint8_t  tick_10ms;   // time since the last acknowledgement
+		uint8_t  resends;
+	} bulk_read;
+
+	static uint16_t bulk_write_next;      // where the next streamed write has to start
+#endif
+
+#ifdef ENABLE_UART_TELEMETRY
+	static sched_timer_t telemetry_timer;
+	static bool          telemetry_running;
+	static reply_053A_t  telemetry;            // the packet being filled
+	static uint16_t      telemetry_period_10ms;
+	static uint32_t      telemetry_end_tick;
+	static unsigned int  telemetry_lost;
+
+	// the last packet, framed and obfuscated, fed to the TX FIFO a bit at a time from the 10ms slice
+	static uint8_t       telemetry_frame[sizeof(Header_t) + sizeof(reply_053A_t) + sizeof(Footer_t)];
+	static unsigned int  telemetry_frame_size;
+	static unsigned int  telemetry_frame_sent;
+#endif
+
 // ****************************************************
 
-static void SendReply(void *preply, uint16_t Size)
+static void ObfuscateReply(void *preply, const uint16_t Size)
 {
-	Header_t Header;
-	Footer_t Footer;
-
 	if (is_encrypted)
 	{
 		uint8_t     *pBytes = (uint8_t *)preply;
@@ -179,23 +340,49 @@ static void SendReply(void *preply, uint16_t Size)
 		for (i = 0; i < Size; i++)
 			pBytes[i] ^= obfuscate_array[i % 16];
 	}
+}
 
-	Header.ID   = 0xCDAB;
-	Header.Size = Size;
-	UART_Send(&Header, sizeof(Header));
-	UART_Send(preply, Size);
-
+static void MakeFooter(Footer_t *pFooter, const uint16_t Size)
+{
 	if (is_encrypted)
 	{
-		Footer.pad[0] = obfuscate_array[(Size + 0) % 16] ^ 0xFF;
-		Footer.pad[1] = obfuscate_array[(Size + 1) % 16] ^ 0xFF;
+		pFooter->pad[0] = obfuscate_array[(Size + 0) % 16] ^ 0xFF;
+		pFooter->pad[1] = obfuscate_array[(Size + 1) % 16] ^ 0xFF;
 	}
 	else
 	{
-		Footer.pad[0] = 0xFF;
-		Footer.pad[1] = 0xFF;
+		pFooter->pad[0] = 0xFF;
+		pFooter->pad[1] = 0xFF;
 	}
-	Footer.ID = 0xBADC;
+	pFooter->ID = 0xBADC;
+}
+
+#ifdef ENABLE_UART_TELEMETRY
+	static void UART_telemetry_flush(void)
+	{	// finish off a part sent telemetry packet, so nothing else gets sent into the middle of it
+		if (telemetry_frame_sent < telemetry_frame_size)
+			UART_Send(telemetry_frame + telemetry_frame_sent, telemetry_frame_size - telemetry_frame_sent);
+		telemetry_frame_sent = telemetry_frame_size;
+	}
+#endif
+
+static void SendReply(void *preply, uint16_t Size)
+{
+	Header_t Header;
+	Footer_t Footer;
+
+	#ifdef ENABLE_UART_TELEMETRY
+		UART_telemetry_flush();
+	#endif
+
+	ObfuscateReply(preply, Size);
+
+	Header.ID   = 0xCDAB;
+	Header.Size = Size;
+	UART_Send(&Header, sizeof(Header));
+	UART_Send(preply, Size);
+
+	MakeFooter(&Footer, Size);
 	UART_Send(&Footer, sizeof(Footer));
 }
 
@@ -246,7 +433,11 @@ static void cmd_0514(const uint8_t *pBuffer)
 
 	time_stamp = pCmd->time_stamp;
 
-	g_serial_config_tick_500ms = serial_config_tick_500ms;
+	SCHEDULER_start(&g_serial_config_timer, serial_config_10ms, 0, NULL);
+
+	#ifdef ENABLE_VFO_JOURNAL
+		SETTINGS_stop_journal();   // the PC only knows about the normal layout
+	#endif
 
 	// show message
 	g_request_display_screen = DISPLAY_MAIN;
@@ -267,7 +458,7 @@ static void cmd_051B(const uint8_t *pBuffer)
 //	if (pCmd->time_stamp != time_stamp)
 //		return;
 
-	g_serial_config_tick_500ms = serial_config_tick_500ms;
+	SCHEDULER_start(&g_serial_config_timer, serial_config_10ms, 0, NULL);
 
 	if (addr >= EEPROM_SIZE)
 		return;
@@ -289,6 +480,10 @@ static void cmd_051B(const uint8_t *pBuffer)
 //	if (g_has_aes_key)
 //		locked = is_locked;
 
+	#ifdef ENABLE_EEPROM_LAZY_LOAD
+		SETTINGS_load(addr, size);
+	#endif
+
 //	if (!locked)
 //		EEPROM_ReadBuffer(addr, reply.Data.Data, size);
 		memcpy(reply.Data.Data, ((uint8_t *)&g_eeprom) + addr, size);
@@ -296,15 +491,75 @@ static void cmd_051B(const uint8_t *pBuffer)
 	SendReply(&reply, size + 8);
 }
 
+static unsigned int write_eeprom(const unsigned int addr, uint8_t *data, const unsigned int size, const bool allow_password)
+{	// tidy up the data in place, then write the lot in one go (a page at a time)
+	// returns the number of bytes written, whole 8 byte blocks only
+
+	const unsigned int write_size    = 8;
+#ifdef INCLUDE_AES
+	bool               reload_eeprom = false;
+#endif
+	unsigned int       i;
+
+	#ifndef ENABLE_PWRON_PASSWORD
+		(void)allow_password;
+	#endif
+
+	#ifdef ENABLE_EEPROM_CACHE
+		SETTINGS_flush();   // so they don't later land on top of the new data
+	#endif
+
+	for (i = 0; i < (size / write_size); i++)
+	{
+		const unsigned int k = i * write_size;
+		const unsigned int Offset = addr + k;
+		uint8_t *block = data + k;
+
+		if ((Offset + write_size) > EEPROM_SIZE)
+			break;
+
+		#ifdef INCLUDE_AES
+			if (Offset >= 0x0F30 && Offset < 0x0F40)     // AES key
+				if (!is_locked)
+					reload_eeprom = true;
+		#else
+			if (Offset == 0x0F30 || Offset == 0x0F38)
+				memset(block, 0xff, 8);   // wipe the AES key
+		#endif
+
+		//#ifndef ENABLE_DTMF_KILL_REVIVE
+			if (Offset == 0x0F40)
+			{	// killed flag is here
+				block[2] = false;	// remove it
+			}
+		//#endif
+
+		#ifdef ENABLE_PWRON_PASSWORD
+			if ((Offset >= 0x0E98 && Offset < 0x0E9C) && g_password_locked && !allow_password)
+				EEPROM_ReadBuffer(Offset, block, write_size);   // leave it as it is
+		#else
+			if (Offset == 0x0E98)
+				memset(block, 0xff, 4);   // wipe the password 
+		#endif
+	}
+
+	EEPROM_WriteBuffer(addr, data, i * write_size);
+
+	#ifdef INCLUDE_AES
+		if (reload_eeprom)
+			SETTINGS_read_eeprom();
+	#endif
+
+	return i * write_size;
+}
+
 // write eeprom
 static void cmd_051D(const uint8_t *pBuffer)
 {
-	const unsigned int write_size    = 8;
 	const cmd_051D_t  *pCmd          = (const cmd_051D_t *)pBuffer;
 	const unsigned int addr          = pCmd->Offset;
 	unsigned int       size          = pCmd->Size;
 #ifdef INCLUDE_AES
-	bool               reload_eeprom = false;
 	bool               locked        = g_has_aes_key ? is_locked : g_has_aes_key;
 #endif
 	reply_051D_t       reply;
@@ -312,7 +567,7 @@ static void cmd_051D(const uint8_t *pBuffer)
 //	if (pCmd->time_stamp != time_stamp)
 //		return;
 
-	g_serial_config_tick_500ms = serial_config_tick_500ms;
+	SCHEDULER_start(&g_serial_config_timer, serial_config_10ms, 0, NULL);
 
 	if (addr >= EEPROM_SIZE)
 		return;
@@ -331,49 +586,7 @@ static void cmd_051D(const uint8_t *pBuffer)
 #ifdef INCLUDE_AES
 	if (!locked)
 #endif
-	{
-		unsigned int i;
-
-		for (i = 0; i < (size / write_size); i++)
-		{
-			const unsigned int k = i * write_size;
-			const unsigned int Offset = addr + k;
-			uint8_t *data = (uint8_t *)pCmd + sizeof(cmd_051D_t) + k;
-
-			if ((Offset + write_size) > EEPROM_SIZE)
-				break;
-
-			#ifdef INCLUDE_AES
-				if (Offset >= 0x0F30 && Offset < 0x0F40)     // AES key
-					if (!is_locked)
-						reload_eeprom = true;
-			#else
-				if (Offset == 0x0F30 || Offset == 0x0F38)
-					memset(data, 0xff, 8);   // wipe the AES key
-			#endif
-
-			//#ifndef ENABLE_DTMF_KILL_REVIVE
-				if (Offset == 0x0F40)
-				{	// killed flag is here
-					data[2] = false;	// remove it
-				}
-			//#endif
-
-			#ifdef ENABLE_PWRON_PASSWORD
-				if ((Offset < 0x0E98 || Offset >= 0x0E9C) || !g_password_locked || pCmd->allow_password)
-					EEPROM_WriteBuffer8(Offset, data);
-			#else
-				if (Offset == 0x0E98)
-					memset(data, 0xff, 4);   // wipe the password 
-				EEPROM_WriteBuffer8(Offset, data);
-			#endif
-		}
-
-		#ifdef INCLUDE_AES
-			if (reload_eeprom)
-				SETTINGS_read_eeprom();
-		#endif
-	}
+		write_eeprom(addr, (uint8_t *)pCmd + sizeof(cmd_051D_t), size, pCmd->allow_password);
 
 	SendReply(&reply, sizeof(reply));
 }
@@ -418,7 +631,7 @@ static void cmd_052D(const uint8_t *pBuffer)
 	uint32_t     response[4];
 	reply_052D_t reply;
 
-	g_serial_config_tick_500ms = serial_config_tick_500ms;
+	SCHEDULER_start(&g_serial_config_timer, serial_config_10ms, 0, NULL);
 
 	if (!locked)
 	{
@@ -474,7 +687,7 @@ static void cmd_052F(const uint8_t *pBuffer)
 	g_vfo_info[0].channel.dtmf_ptt_id_tx_mode  = PTT_ID_OFF;
 	g_vfo_info[0].channel.dtmf_decoding_enable = false;
 
-	g_serial_config_tick_500ms = serial_config_tick_500ms;
+	SCHEDULER_start(&g_serial_config_timer, serial_config_10ms, 0, NULL);
 
 	#ifdef ENABLE_NOAA
 		g_noaa_mode = false;
@@ -492,6 +705,404 @@ static void cmd_052F(const uint8_t *pBuffer)
 	SendVersion();
 }
 
+#ifdef ENABLE_SLICE_STATS
+	static void cmd_0531(const uint8_t *pBuffer)
+	{
+		const cmd_0531_t *pCmd = (const cmd_0531_t *)pBuffer;
+		reply_0531_t      reply;
+
+		memset(&reply, 0, sizeof(reply));
+		reply.Header.ID    = 0x0532;
+		reply.Header.Size  = sizeof(reply.Data);
+		reply.Data.time_us = SYSTICK_get_us();
+		memcpy(reply.Data.slice, g_time_slice_stats, sizeof(reply.Data.slice));
+		reply.Data.boot_rx_us = g_boot_rx_us;
+		reply.Data.loaded_us  = g_boot_loaded_us;
+		#ifdef ENABLE_BK4819_REG_CACHE
+			reply.Data.reg_hits   = g_bk4819_reg_cache_hits;
+			reply.Data.reg_misses = g_bk4819_reg_cache_misses;
+		#endif
+
+		if (pCmd->Header.Size >= 1 && pCmd->clear)
+		{
+			memset(g_time_slice_stats, 0, sizeof(g_time_slice_stats));
+			#ifdef ENABLE_BK4819_REG_CACHE
+				g_bk4819_reg_cache_hits   = 0;
+				g_bk4819_reg_cache_misses = 0;
+			#endif
+		}
+
+		SendReply(&reply, sizeof(reply));
+	}
+#endif
+
+#ifdef ENABLE_UART_BULK_EEPROM
+	// bulk eeprom read
+	static void cmd_0533(const uint8_t *pBuffer)
+	{
+		const cmd_0533_t  *pCmd = (const cmd_0533_t *)pBuffer;
+		const unsigned int addr = pCmd->Offset;
+		unsigned int       size = pCmd->Size;
+
+		SCHEDULER_start(&g_serial_config_timer, serial_config_10ms, 0, NULL);
+
+		if (addr >= EEPROM_SIZE)
+			size = 0;
+		if (size > (EEPROM_SIZE - addr))
+			size =  EEPROM_SIZE - addr;
+
+		#ifdef ENABLE_VFO_JOURNAL
+			if (size > 0)
+				SETTINGS_stop_journal();   // the PC only knows about the normal layout
+		#endif
+
+		bulk_read.sent      = addr;
+		bulk_read.acked     = addr;
+		bulk_read.end       = addr + size;
+		bulk_read.block     = (pCmd->block == 0 || pCmd->block > BULK_BLOCK_SIZE) ? BULK_BLOCK_SIZE : pCmd->block;
+		bulk_read.window    = (pCmd->window == 0) ? 1 : pCmd->window;
+		bulk_read.tick_10ms = 0;
+		bulk_read.resends   = 0;
+
+		UART_process_bulk();   // make a start
+	}
+
+	// bulk eeprom read acknowledge
+	static void cmd_0535(const uint8_t *pBuffer)
+	{
+		const cmd_0535_t  *pCmd = (const cmd_0535_t *)pBuffer;
+		const unsigned int addr = pCmd->Offset;
+
+		SCHEDULER_start(&g_serial_config_timer, serial_config_10ms, 0, NULL);
+
+		if (bulk_read.acked >= bulk_read.end || addr < bulk_read.acked || addr > bulk_read.sent)
+			return;   // not reading, or it's old news
+
+		if (addr > bulk_read.acked)
+		{
+			bulk_read.acked     = addr;
+			bulk_read.tick_10ms = 0;
+			bulk_read.resends   = 0;
+		}
+
+		if (pCmd->resend)
+			bulk_read.sent = bulk_read.acked;
+
+		UART_process_bulk();
+	}
+
+	// bulk eeprom write
+	static void cmd_0537(const uint8_t *pBuffer)
+	{
+		const cmd_0537_t  *pCmd   = (const cmd_0537_t *)pBuffer;
+		const unsigned int addr   = pCmd->Offset;
+		unsigned int       size   = pCmd->Size;
+	#ifdef INCLUDE_AES
+		const bool         locked = g_has_aes_key ? is_locked : g_has_aes_key;
+	#endif
+		reply_0538_t       reply;
+
+		SCHEDULER_start(&g_serial_config_timer, serial_config_10ms, 0, NULL);
+
+		if (pCmd->first)
+		{
+			bulk_write_next = addr;
+
+			#ifdef ENABLE_VFO_JOURNAL
+				SETTINGS_stop_journal();   // the PC only knows about the normal layout
+			#endif
+		}
+
+		if (size > (EEPROM_SIZE - addr))
+			size =  EEPROM_SIZE - addr;
+
+		if (addr == bulk_write_next && addr < EEPROM_SIZE &&
+		    (sizeof(cmd_0537_t) - sizeof(Header_t) + size) <= pCmd->Header.Size)   // the data's all there
+		{
+		#ifdef INCLUDE_AES
+			if (!locked)
+		#endif
+				bulk_write_next = addr + write_eeprom(addr, (uint8_t *)pCmd + sizeof(cmd_0537_t), size, pCmd->allow_password);
+		}
+
+		memset(&reply, 0, sizeof(reply));
+		reply.Header.ID   = 0x0538;
+		reply.Header.Size = sizeof(reply.Data);
+		reply.Data.Offset = bulk_write_next;
+
+		SendReply(&reply, sizeof(reply));
+	}
+
+	void UART_process_bulk(void)
+	{	// called every 10ms, send the next packet of a bulk read if the window allows
+
+		reply_0534_t reply;
+		unsigned int size;
+
+		if (bulk_read.acked >= bulk_read.end)
+			return;
+
+		if (bulk_read.sent >= bulk_read.end || (unsigned int)(bulk_read.sent - bulk_read.acked) >= ((unsigned int)bulk_read.window * bulk_read.block))
+		{	// waiting to hear back from the PC
+			if (++bulk_read.tick_10ms < BULK_RESEND_10ms)
+				return;
+
+			bulk_read.tick_10ms = 0;
+
+			if (++bulk_read.resends > BULK_RESENDS)
+			{	// it's gone away
+				bulk_read.end = bulk_read.acked;
+				return;
+			}
+
+			bulk_read.sent = bulk_read.acked;   // go back to what it's missing
+		}
+
+		size = bulk_read.end - bulk_read.sent;
+		if (size > bulk_read.block)
+			size = bulk_read.block;
+
+		#ifdef ENABLE_EEPROM_LAZY_LOAD
+			SETTINGS_load(bulk_read.sent, size);
+		#endif
+
+		memset(&reply, 0, sizeof(reply));
+		reply.Header.ID   = 0x0534;
+		reply.Header.Size = size + 4;
+		reply.Data.Offset = bulk_read.sent;
+		reply.Data.Size   = size;
+		memcpy(reply.Data.Data, ((uint8_t *)&g_eeprom) + bulk_read.sent, size);
+
+		bulk_read.sent += size;
+
+		SendReply(&reply, size + 8);
+	}
+#endif
+
+#ifdef ENABLE_UART_TELEMETRY
+	void UART_telemetry_drain(void)
+	{	// called from the 10ms slice, gives the TX FIFO as much of the packet as it'll take without waiting
+		if (telemetry_frame_sent < telemetry_frame_size)
+			telemetry_frame_sent += UART_SendSome(telemetry_frame + telemetry_frame_sent, telemetry_frame_size - telemetry_frame_sent);
+	}
+
+	static void UART_telemetry_send(void)
+	{	// frame the packet up for UART_telemetry_drain() to send .. if the last one's still going out,
+		// these samples are counted as lost rather than holding the radio up for it
+
+		const unsigned int size    = sizeof(telemetry.Data) - sizeof(telemetry.Data.sample) + (telemetry.Data.count * sizeof(telemetry_sample_t));
+		const uint16_t     Size    = sizeof(Header_t) + size;
+		Header_t          *pHeader = (Header_t *)telemetry_frame;
+
+		if (telemetry_frame_sent < telemetry_frame_size)
+		{
+			telemetry_lost      += telemetry.Data.count;
+			telemetry.Data.count = 0;
+			return;
+		}
+
+		telemetry.Header.ID   = 0x053A;
+		telemetry.Header.Size = size;
+		telemetry.Data.lost   = (telemetry_lost < 255) ? telemetry_lost : 255;
+
+		pHeader->ID   = 0xCDAB;
+		pHeader->Size = Size;
+		memcpy(telemetry_frame + sizeof(Header_t), &telemetry, Size);
+		ObfuscateReply(telemetry_frame + sizeof(Header_t), Size);
+		MakeFooter((Footer_t *)(telemetry_frame + sizeof(Header_t) + Size), Size);
+
+		telemetry_frame_size = sizeof(Header_t) + Size + sizeof(Footer_t);
+		telemetry_frame_sent = 0;
+
+		memset(&telemetry, 0, sizeof(telemetry));
+		telemetry_lost = 0;
+
+		UART_telemetry_drain();
+	}
+
+	static void UART_telemetry_sample(void)
+	{	// called from the scheduler every telemetry_period_10ms
+
+		const uint32_t      now       = SCHEDULER_ticks();
+		const uint32_t      frequency = g_rx_vfo->p_rx->frequency;
+		const bool          done      = (int32_t)(now - telemetry_end_tick) >= 0;
+		bool                away      = false;
+		telemetry_sample_t *sample;
+
+		// the panadapter sweep and the spectrum screen have the BK4819 tuned somewhere other
+		// than the VFO, so there's nothing to take for it
+		#ifdef ENABLE_PANADAPTER
+			if (PAN_scanning())
+				away = true;
+		#endif
+		#ifdef ENABLE_SPECTRUM
+			if (g_current_display_screen == DISPLAY_SPECTRUM)
+				away = true;
+		#endif
+
+		if (away)
+			telemetry_lost++;
+		else
+		{
+			if (telemetry.Data.count > 0 && telemetry.Data.frequency != frequency)
+				UART_telemetry_send();   // moved on (scanning), the samples so far go out with the old one
+
+			telemetry.Data.frequency = frequency;
+
+			sample            = &telemetry.Data.sample[telemetry.Data.count++];
+			sample->tick_10ms = now;
+			sample->rssi      = (BK4819_GetRSSI() & 0x01FF) | (g_squelch_open ? 0x8000 : 0);
+			sample->noise     = BK4819_GetExNoiceIndicator();
+			sample->glitch    = BK4819_GetGlitchIndicator();
+		}
+
+		// send every 100ms or so, or every sample if they're further apart than that
+		if (telemetry.Data.count >= TELEMETRY_SAMPLES || (telemetry.Data.count * telemetry_period_10ms) >= (100 / 10) || done)
+			UART_telemetry_send();
+
+		if (done)
+		{
+			SCHEDULER_stop(&telemetry_timer);
+			telemetry_running = false;
+		}
+	}
+
+	// telemetry subscribe
+	static void cmd_0539(const uint8_t *pBuffer)
+	{
+		const cmd_0539_t *pCmd = (const cmd_0539_t *)pBuffer;
+
+		if (pCmd->Header.Size < (sizeof(cmd_0539_t) - sizeof(Header_t)))
+			return;
+
+		if (telemetry.Data.count > 0)
+			UART_telemetry_send();   // what's been taken so far
+
+		if (pCmd->period_10ms == 0 || pCmd->seconds == 0)
+		{
+			SCHEDULER_stop(&telemetry_timer);
+			telemetry_running = false;
+			telemetry_lost    = 0;
+			return;
+		}
+
+		telemetry_end_tick = SCHEDULER_ticks() + (pCmd->seconds * (1000u / 10));
+
+		if (!telemetry_running || pCmd->period_10ms != telemetry_period_10ms)
+		{	// only restart it if the rate's changed, a renewal carries on as it was
+			telemetry_running     = true;
+			telemetry_period_10ms = pCmd->period_10ms;
+			SCHEDULER_start(&telemetry_timer, telemetry_period_10ms, telemetry_period_10ms, UART_telemetry_sample);
+		}
+	}
+#endif
+
+#ifdef ENABLE_UART_RX_PARSER
+	static uint16_t UART_crc_byte(uint16_t crc, const uint8_t data)
+	{	// CRC-16/CCITT a nibble at a time, the same as the CRC peripheral (which MDC1200 also uses)
+		static const uint16_t table[16] = {
+			0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+			0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+		};
+		crc = (crc << 4) ^ table[(crc >> 12) ^ (data >> 4)];
+		crc = (crc << 4) ^ table[(crc >> 12) ^ (data & 0x0F)];
+		return crc;
+	}
+
+	bool UART_IsCommandAvailable(void)
+	{	// carry on through whatever's arrived since last time, stopping at the end of a good packet
+
+		const uint16_t DmaLength = DMA_CH0->ST & 0xFFFU;
+
+		while (rx.index != DmaLength)
+		{
+			uint8_t *p    = &UART_DMA_Buffer[rx.index];
+			uint8_t  data = *p;
+
+			rx.index = DMA_INDEX(rx.index, 1);
+
+			switch (rx.state)
+			{
+				case RX_HUNT:
+					if (data == 0xAB)
+						rx.state = RX_START;
+					break;
+
+				case RX_START:
+					rx.state = (data == 0xCD) ? RX_SIZE_LO : (data == 0xAB) ? RX_START : RX_HUNT;
+					break;
+
+				case RX_SIZE_LO:
+					rx.size  = data;
+					rx.state = RX_SIZE_HI;
+					break;
+
+				case RX_SIZE_HI:
+					rx.size |= (uint16_t)data << 8;
+					rx.start = rx.index;
+					rx.count = 0;
+					rx.crc   = 0;
+					rx.state = ((rx.size + 8u) > sizeof(UART_DMA_Buffer) || rx.size < sizeof(Header_t)) ? RX_HUNT : RX_PAYLOAD;
+					break;
+
+				case RX_PAYLOAD:
+					if (rx.count == 1)
+					{	// the first ID byte was left as it came, the pair of them tell us if it's obfuscated
+						uint8_t *p0 = &UART_DMA_Buffer[rx.start];
+
+						if (*p0 == 0x14 && data == 0x05)
+							is_encrypted = false;   // 0x0514
+						if (*p0 == 0x02 && data == 0x69)
+							is_encrypted = true;    // 0x0514 obfuscated
+
+						if (is_encrypted)
+							*p0 ^= obfuscate_array[0];
+						rx.crc = UART_crc_byte(rx.crc, *p0);
+					}
+
+					if (is_encrypted && rx.count > 0)
+						*p = data ^= obfuscate_array[rx.count % 16];
+
+					if (rx.count > 0 && rx.count < rx.size)
+						rx.crc = UART_crc_byte(rx.crc, data);
+
+					if (++rx.count >= (rx.size + 2u))
+						rx.state = RX_FOOTER_DC;
+					break;
+
+				case RX_FOOTER_DC:
+					rx.state = (data == 0xDC) ? RX_FOOTER_BA : RX_HUNT;
+					break;
+
+				case RX_FOOTER_BA:
+				{
+					const unsigned int crc_index = DMA_INDEX(rx.start, rx.size);
+					const uint16_t     crc       = UART_DMA_Buffer[crc_index] | (UART_DMA_Buffer[DMA_INDEX(crc_index, 1)] << 8);
+
+					rx.state = RX_HUNT;
+
+					if (data != 0xBA || crc != rx.crc)
+						break;
+
+					if ((rx.start + rx.size) > sizeof(UART_DMA_Buffer))
+					{	// it wraps round the end of the ring
+						const uint16_t ChunkSize = sizeof(UART_DMA_Buffer) - rx.start;
+						memcpy(UART_Command.Buffer, UART_DMA_Buffer + rx.start, ChunkSize);
+						memcpy(UART_Command.Buffer + ChunkSize, UART_DMA_Buffer, rx.size - ChunkSize);
+					}
+					else
+						memcpy(UART_Command.Buffer, UART_DMA_Buffer + rx.start, rx.size);
+
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+#else
+
 bool UART_IsCommandAvailable(void)
 {
 	uint16_t Index;
@@ -585,6 +1196,8 @@ bool UART_IsCommandAvailable(void)
 	return (CRC_Calculate(UART_Command.Buffer, Size) != CRC) ? false : true;
 }
 
+#endif
+
 void UART_HandleCommand(void)
 {
 	switch (UART_Command.Header.ID)
@@ -625,7 +1238,39 @@ void UART_HandleCommand(void)
 			cmd_052F(UART_Command.Buffer);
 			break;
 
+		#ifdef ENABLE_SLICE_STATS
+			case 0x0531:    // read time slice stats
+				cmd_0531(UART_Command.Buffer);
+				break;
+		#endif
+
+		#ifdef ENABLE_UART_BULK_EEPROM
+			case 0x0533:    // bulk read eeprom
+				cmd_0533(UART_Command.Buffer);
+				break;
+
+			case 0x0535:    // bulk read eeprom acknowledge
+				cmd_0535(UART_Command.Buffer);
+				break;
+
+			case 0x0537:    // bulk write eeprom
+				cmd_0537(UART_Command.Buffer);
+				break;
+		#endif
+
+		#ifdef ENABLE_UART_TELEMETRY
+			case 0x0539:    // telemetry subscribe
+				cmd_0539(UART_Command.Buffer);
+				break;
+		#endif
+
 		case 0x05DD:    // reboot
+			#ifdef ENABLE_EEPROM_CACHE
+				SETTINGS_flush();
+			#endif
+			#ifdef ENABLE_EEPROM_QUEUE
+				EEPROM_flush();
+			#endif
 			#if defined(ENABLE_OVERLAY)
 				overlay_FLASH_RebootToBootloader();
 			#else
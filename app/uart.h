@@ -21,6 +21,12 @@
 
 bool UART_IsCommandAvailable(void);
 void UART_HandleCommand(void);
+#ifdef ENABLE_UART_BULK_EEPROM
+	void UART_process_bulk(void);
+#endif
+#ifdef ENABLE_UART_TELEMETRY
+	void UART_telemetry_drain(void);
+#endif
 
 #endif
 
@@ -69,10 +69,16 @@
 	voice_id_t        g_voice_id[8];
 	uint8_t           g_voice_read_index;
 	uint8_t           g_voice_write_index;
-	volatile uint16_t g_play_next_voice_tick_10ms;
 	volatile bool     g_flag_play_queued_voice;
 	voice_id_t        g_another_voice_id = VOICE_ID_INVALID;
 
+	static sched_timer_t play_next_voice_timer;
+
+	static void AUDIO_next_voice_due(void)
+	{
+		g_flag_play_queued_voice = true;
+	}
+
 #endif
 
 beep_type_t g_beep_to_play = BEEP_NONE;
@@ -357,9 +363,9 @@ void AUDIO_PlayBeep(beep_type_t Beep)
 			return;
 		}
 
-		g_voice_read_index          = 1;
-		g_play_next_voice_tick_10ms = Delay;
-		g_flag_play_queued_voice    = false;
+		g_voice_read_index       = 1;
+		g_flag_play_queued_voice = false;
+		SCHEDULER_start(&play_next_voice_timer, Delay, 0, AUDIO_next_voice_due);
 
 		return;
 
@@ -470,8 +476,8 @@ void AUDIO_PlayBeep(beep_type_t Beep)
 
 				AUDIO_PlayVoice(VoiceID);
 
-				g_play_next_voice_tick_10ms = Delay;
-				g_flag_play_queued_voice           = false;
+				g_flag_play_queued_voice = false;
+				SCHEDULER_start(&play_next_voice_timer, Delay, 0, AUDIO_next_voice_due);
 
 				#ifdef ENABLE_VOX
 					g_vox_resume_tick_10ms = 2000;
@@ -14,6 +14,8 @@
  *     limitations under the License.
  */
 
+#include <string.h>     // memset
+
 #include "bk4819.h"
 #include "bsp/dp32g030/gpio.h"
 #include "bsp/dp32g030/portcon.h"
@@ -36,6 +38,20 @@
 
 static uint16_t g_bk4819_gpio_out_state;
 
+#ifdef ENABLE_BK4819_REG_CACHE
+	// write-through copy of the registers, lets us skip re-sending an unchanged value
+	static uint16_t bk4819_reg_cache[128];
+	static uint32_t bk4819_reg_cache_valid[128 / 32];
+
+	uint32_t g_bk4819_reg_cache_hits;
+	uint32_t g_bk4819_reg_cache_misses;
+#endif
+
+// when not NULL the register writes are collected here instead of being sent
+static BK4819_reg_pair_t *bk4819_record_list;
+static unsigned int       bk4819_record_size;
+static unsigned int       bk4819_record_count;
+
 //const uint32_t rf_filter_transition_freq = 28000000;  // original
   const uint32_t rf_filter_transition_freq = 26500000;
 
@@ -199,6 +215,15 @@ static uint16_t BK4819_read_16(void)
 uint16_t BK4819_read_reg(const uint8_t Register)
 {
 	uint16_t Value;
+
+	if (bk4819_record_list != NULL)
+	{	// the chip hasn't seen the recorded writes yet, so the latest of those wins
+		unsigned int i = bk4819_record_count;
+		while (i-- > 0)
+			if (bk4819_record_list[i].reg == Register)
+				return bk4819_record_list[i].value;
+	}
+
 	GPIO_SetBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SCN);
 	GPIO_ClearBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SCL);
 	SYSTICK_Delay250ns(1);  // 4
@@ -212,8 +237,96 @@ uint16_t BK4819_read_reg(const uint8_t Register)
 	return Value;
 }
 
+#ifdef ENABLE_BK4819_REG_CACHE
+	static bool BK4819_reg_is_volatile(const unsigned int Register)
+	{	// registers that must always be written
+		switch (Register)
+		{
+			case 0x00:   // soft reset
+			case 0x02:   // interrupt clear
+			case 0x08:   // CDCSS code, indexed by bit-15
+			case 0x09:   // DTMF coefficients, indexed by bits 15:12
+			case 0x30:   // toggled to re-calibrate the VCO/PLL
+			case 0x59:   // FSK FIFO clear bits are self clearing
+			case 0x5F:   // FSK data FIFO
+				return true;
+		}
+		return false;
+	}
+
+	static void BK4819_invalidate_regs(void)
+	{
+		memset(bk4819_reg_cache_valid, 0, sizeof(bk4819_reg_cache_valid));
+	}
+#endif
+
+#ifdef ENABLE_BK4819_REG_CACHE
+	static bool BK4819_reg_unchanged(const uint8_t Register, const uint16_t Data)
+	{	// true if the chip already has this value, else updates the cache ready for the write
+		const unsigned int reg  = Register & 0x7f;
+		const uint32_t     mask = 1u << (reg & 31);
+
+		if ((bk4819_reg_cache_valid[reg >> 5] & mask) && bk4819_reg_cache[reg] == Data)
+		{
+			g_bk4819_reg_cache_hits++;
+			return true;
+		}
+
+		g_bk4819_reg_cache_misses++;
+
+		if (reg == 0x00)
+		{	// a reset puts every register back to it's default
+			BK4819_invalidate_regs();
+		}
+		else
+		if (!BK4819_reg_is_volatile(reg))
+		{
+			bk4819_reg_cache[reg]               = Data;
+			bk4819_reg_cache_valid[reg >> 5] |= mask;
+		}
+
+		return false;
+	}
+#endif
+
+void BK4819_record_regs(BK4819_reg_pair_t *list, const unsigned int size)
+{	// collect the register writes into 'list' rather than sending them, until BK4819_record_stop()
+	bk4819_record_list  = list;
+	bk4819_record_size  = size;
+	bk4819_record_count = 0;
+}
+
+unsigned int BK4819_record_stop(void)
+{	// returns the number of writes collected, 0 if the list filled up and they've already been sent
+	bk4819_record_list = NULL;
+	return bk4819_record_count;
+}
+
 void BK4819_write_reg(const uint8_t Register, uint16_t Data)
 {
+	if (bk4819_record_list != NULL)
+	{
+		if (bk4819_record_count < bk4819_record_size)
+		{
+			bk4819_record_list[bk4819_record_count].reg   = Register;
+			bk4819_record_list[bk4819_record_count].value = Data;
+			bk4819_record_count++;
+			return;
+		}
+
+		{	// full .. send what we have and stop recording, the order is kept
+			BK4819_reg_pair_t *list = bk4819_record_list;
+			bk4819_record_list = NULL;
+			BK4819_write_regs(list, bk4819_record_count);
+			bk4819_record_count = 0;
+		}
+	}
+
+	#ifdef ENABLE_BK4819_REG_CACHE
+		if (BK4819_reg_unchanged(Register, Data))
+			return;
+	#endif
+
 	GPIO_SetBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SCN);
 	GPIO_ClearBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SCL);
 	SYSTICK_Delay250ns(1);  // 4
@@ -226,6 +339,40 @@ void BK4819_write_reg(const uint8_t Register, uint16_t Data)
 	GPIO_SetBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SDA);
 }
 
+void BK4819_write_regs(const BK4819_reg_pair_t *list, const unsigned int count)
+{	// send a prebuilt register list in one go, the bus is only idled at the end
+	unsigned int i;
+	bool         sent = false;
+
+	for (i = 0; i < count; i++)
+	{
+		#ifdef ENABLE_BK4819_REG_CACHE
+			if (BK4819_reg_unchanged(list[i].reg, list[i].value))
+				continue;
+		#endif
+
+		if (!sent)
+		{
+			GPIO_SetBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SCN);
+			GPIO_ClearBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SCL);
+			SYSTICK_Delay250ns(1);  // 4
+			sent = true;
+		}
+
+		GPIO_ClearBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SCN);
+		BK4819_write_8(list[i].reg);
+		BK4819_write_16(list[i].value);
+		GPIO_SetBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SCN);
+		SYSTICK_Delay250ns(1);  // 4
+	}
+
+	if (sent)
+	{
+		GPIO_SetBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SCL);
+		GPIO_SetBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SDA);
+	}
+}
+
 void BK4819_write_8(uint8_t Data)
 {
 	unsigned int i;
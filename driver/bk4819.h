@@ -59,11 +59,24 @@ enum BK4819_CSS_scan_result_e
 };
 typedef enum BK4819_CSS_scan_result_e BK4819_CSS_scan_result_t;
 
+typedef struct {
+	uint8_t  reg;
+	uint16_t value;
+} BK4819_reg_pair_t;
+
 extern bool g_rx_idle_mode;
 
+#ifdef ENABLE_BK4819_REG_CACHE
+	extern uint32_t g_bk4819_reg_cache_hits;
+	extern uint32_t g_bk4819_reg_cache_misses;
+#endif
+
 void     BK4819_Init(void);
 uint16_t BK4819_read_reg(const uint8_t Register);
 void     BK4819_write_reg(const uint8_t Register, uint16_t Data);
+void     BK4819_write_regs(const BK4819_reg_pair_t *list, const unsigned int count);
+void     BK4819_record_regs(BK4819_reg_pair_t *list, const unsigned int size);
+unsigned int BK4819_record_stop(void);
 void     BK4819_write_8(uint8_t Data);
 void     BK4819_write_16(uint16_t Data);
 
@@ -14,17 +14,182 @@
  *     limitations under the License.
  */
 
-#include <string.h>     // NULL and memcmp
+
+#include <string.h>     // NULL, memcmp, memcpy, memset
 
 #include "driver/eeprom.h"
 #include "driver/i2c.h"
 #include "driver/system.h"
+#ifdef ENABLE_EEPROM_QUEUE
+	#include "driver/systick.h"
+#endif
+
+// the BL24C64 burns up to a 32-byte page in one go, taking the same time as a single byte,
+// but a write that runs past the end of a page wraps round to the start of the same page
+#define EEPROM_PAGE_SIZE   32
+
+static void EEPROM_write(const uint16_t address, const void *p_buffer, const unsigned int size)
+{	// start a write, 'size' bytes must not cross a page boundary
+	I2C_Start();
+	I2C_Write(0xA0);
+	I2C_Write((address >> 8) & 0xFF);
+	I2C_Write((address >> 0) & 0xFF);
+	I2C_WriteBuffer(p_buffer, size);
+	I2C_Stop();
+}
+
+#ifdef ENABLE_EEPROM_QUEUE
+	// writes are queued (8 bytes or less per entry) and burnt in the background from the 10ms
+	// time slice, rather than stalling everything for 6ms per write
+	//
+	// reads see the queued data, so apart from a power cut it looks no different to the old way
+
+	#define EEPROM_QUEUE_SIZE   16
+
+	typedef struct {
+		uint16_t address;
+		uint8_t  size;
+		uint8_t  data[8];
+	} eeprom_block_t;
+
+	static eeprom_block_t eeprom_queue[EEPROM_QUEUE_SIZE];   // [0] is the oldest
+	static unsigned int   eeprom_queue_count;
+	static bool           eeprom_busy;                       // the chip is (or might be) still burning the last write
+
+	static bool EEPROM_overlaps(const eeprom_block_t *block, const unsigned int address, const unsigned int size)
+	{
+		return (block->address + block->size) > address && block->address < (address + size);
+	}
+
+	static bool EEPROM_ready(void)
+	{	// ACK polling .. the chip doesn't ACK its address until it's finished burning
+		bool ack;
+
+		I2C_Start();
+		ack = (I2C_Write(0xA0) == 0);
+		I2C_Stop();
+
+		if (ack)
+			eeprom_busy = false;
+
+		return ack;
+	}
+
+	static void EEPROM_wait_ready(void)
+	{
+		unsigned int i;
+
+		if (!eeprom_busy)
+			return;
+
+		for (i = 0; i < 100 && !EEPROM_ready(); i++)   // give up after 10ms
+			SYSTICK_Delay250ns(100 * 4);                // 100us
+
+		eeprom_busy = false;
+	}
+
+	static void EEPROM_write_next(void)
+	{	// start burning the oldest queued write, along with any others that carry on from it in the same page
+
+		const uint16_t     address  = eeprom_queue[0].address;
+		const unsigned int page_end = (address | (EEPROM_PAGE_SIZE - 1)) + 1;
+		uint8_t            data[EEPROM_PAGE_SIZE];
+		bool               merged[EEPROM_QUEUE_SIZE];
+		unsigned int       size = eeprom_queue[0].size;
+		unsigned int       i;
+		unsigned int       j;
+		unsigned int       k;
+
+		memcpy(data, eeprom_queue[0].data, size);
+		memset(merged, 0, sizeof(merged));
+		merged[0] = true;
+
+		for (i = 1; i < eeprom_queue_count; i++)
+		{
+			for (j = 1; j < eeprom_queue_count; j++)
+			{
+				const eeprom_block_t *block = &eeprom_queue[j];
+
+				if (merged[j] || block->address != (address + size) || (block->address + block->size) > page_end)
+					continue;
+
+				// it can't jump ahead of an older write to the same bytes
+				for (k = 1; k < j; k++)
+					if (!merged[k] && EEPROM_overlaps(&eeprom_queue[k], block->address, block->size))
+						break;
+				if (k < j)
+					continue;
+
+				memcpy(data + size, block->data, block->size);
+				size     += block->size;
+				merged[j] = true;
+				break;
+			}
+
+			if (j >= eeprom_queue_count)
+				break;   // nothing more carries on from it
+		}
+
+		EEPROM_wait_ready();
+		EEPROM_write(address, data, size);
+		eeprom_busy = true;
+
+		// drop what's just been written from the queue
+		for (i = 0, j = 0; i < eeprom_queue_count; i++)
+			if (!merged[i])
+				eeprom_queue[j++] = eeprom_queue[i];
+		eeprom_queue_count = j;
+	}
+
+	static void EEPROM_queue_write(const uint16_t address, const uint8_t *p_buffer, const unsigned int size)
+	{	// 'size' is 8 or less
+		unsigned int i;
+
+		// still queued ? .. just update it, as long as no later write overlaps it
+		for (i = eeprom_queue_count; i > 0; i--)
+		{
+			eeprom_block_t *block = &eeprom_queue[i - 1];
+			if (block->address == address && block->size == size)
+			{
+				memcpy(block->data, p_buffer, size);
+				return;
+			}
+			if (EEPROM_overlaps(block, address, size))
+				break;
+		}
+
+		if (eeprom_queue_count >= EEPROM_QUEUE_SIZE)
+			EEPROM_write_next();   // full, make room
+
+		eeprom_queue[eeprom_queue_count].address = address;
+		eeprom_queue[eeprom_queue_count].size    = size;
+		memcpy(eeprom_queue[eeprom_queue_count].data, p_buffer, size);
+		eeprom_queue_count++;
+	}
+
+	void EEPROM_process(void)
+	{	// called every 10ms .. start the next queued write if the chip has finished the last one
+		if (eeprom_queue_count > 0 && (!eeprom_busy || EEPROM_ready()))
+			EEPROM_write_next();
+	}
+
+	void EEPROM_flush(void)
+	{	// write everything out now (before a reboot)
+		while (eeprom_queue_count > 0)
+			EEPROM_write_next();
+		EEPROM_wait_ready();
+	}
+#endif
 
 void EEPROM_ReadBuffer(const uint16_t address, void *p_buffer, const unsigned int size)
 {
 	if ((address + size) > 0x2000 || size == 0)
 		return;
 
+	#ifdef ENABLE_EEPROM_QUEUE
+		EEPROM_wait_ready();
+	#endif
+
 	I2C_Start();
 	I2C_Write(0xA0);
 	I2C_Write((address >> 8) & 0xFF);
@@ -35,29 +200,85 @@ void EEPROM_ReadBuffer(const uint16_t address, void *p_buffer, const unsigned in
 //	I2C_ReadBuffer(p_buffer, size, false);
 	I2C_ReadBuffer(p_buffer, size, true);   // faster read
 	I2C_Stop();
+
+	#ifdef ENABLE_EEPROM_QUEUE
+	{	// overlay anything that's still waiting to be written, oldest first
+		unsigned int i;
+		for (i = 0; i < eeprom_queue_count; i++)
+		{
+			const eeprom_block_t *block = &eeprom_queue[i];
+			const unsigned int    start = (block->address > address) ? block->address : address;
+			const unsigned int    end   = ((block->address + block->size) < (address + size)) ? block->address + block->size : address + size;
+			if (start < end)
+				memcpy((uint8_t *)p_buffer + (start - address), &block->data[start - block->address], end - start);
+		}
+	}
+	#endif
 }
 
-void EEPROM_WriteBuffer8(const uint16_t address, const void *p_buffer)
-{
-	if (p_buffer == NULL || (address + 8) > 0x2000)
+static void EEPROM_write_buffer(const uint16_t address, const void *p_buffer, const unsigned int size, const bool compare)
+{	// write any number of bytes, splitting it on the page boundaries
+
+	const uint8_t *data = (const uint8_t *)p_buffer;
+	unsigned int   addr = address;
+	unsigned int   left = size;
+
+	if (p_buffer == NULL || (address + size) > 0x2000)
 		return;
 
-#if 1
-	// eeprom wear reduction
-	// only write the data if it's different to what's already there
-	uint8_t buffer[8];
-	EEPROM_ReadBuffer(address, buffer, 8);
-	if (memcmp(p_buffer, buffer, 8) != 0)
-#endif
+	while (left > 0)
 	{
-		I2C_Start();
-		I2C_Write(0xA0);
-		I2C_Write((address >> 8) & 0xFF);
-		I2C_Write((address >> 0) & 0xFF);
-		I2C_WriteBuffer(p_buffer, 8);
-		I2C_Stop();
+		unsigned int chunk = EEPROM_PAGE_SIZE - (addr % EEPROM_PAGE_SIZE);
+		uint8_t      buffer[EEPROM_PAGE_SIZE];
+
+		if (chunk > left)
+			chunk = left;
+
+		// eeprom wear reduction
+		// only write the data that's different to what's already there
+		if (compare)
+			EEPROM_ReadBuffer(addr, buffer, chunk);
+
+		#ifdef ENABLE_EEPROM_QUEUE
+		{	// queue the changed 8-byte blocks, the queue puts them back together into page writes
+			unsigned int i = 0;
+			while (i < chunk)
+			{
+				unsigned int n = 8 - ((addr + i) % 8);
+				if (n > (chunk - i))
+					n = chunk - i;
+				if (!compare || memcmp(data + i, buffer + i, n) != 0)
+					EEPROM_queue_write(addr + i, data + i, n);
+				i += n;
+			}
+		}
+		#else
+			if (!compare || memcmp(data, buffer, chunk) != 0)
+			{
+				EEPROM_write(addr, data, chunk);
+
+				// give the EEPROM time to burn the data in (apparently takes 1.5ms ~ 5ms)
+				SYSTEM_DelayMs(6);
+			}
+		#endif
 
-		// give the EEPROM time to burn the data in (apparently takes 1.5ms ~ 5ms)
-		SYSTEM_DelayMs(6);
+		addr += chunk;
+		data += chunk;
+		left -= chunk;
 	}
 }
+
+void EEPROM_WriteBuffer(const uint16_t address, const void *p_buffer, const unsigned int size)
+{
+	EEPROM_write_buffer(address, p_buffer, size, true);
+}
+
+void EEPROM_WriteBufferChanged(const uint16_t address, const void *p_buffer, const unsigned int size)
+{	// the caller already knows it's different to what's in the eeprom, so don't bother reading it back
+	EEPROM_write_buffer(address, p_buffer, size, false);
+}
+
+void EEPROM_WriteBuffer8(const uint16_t address, const void *p_buffer)
+{
+	EEPROM_WriteBuffer(address, p_buffer, 8);
+}
@@ -20,7 +20,13 @@
 #include <stdint.h>
 
 void EEPROM_ReadBuffer(const uint16_t address, void *p_buffer, const unsigned int size);
+void EEPROM_WriteBuffer(const uint16_t address, const void *p_buffer, const unsigned int size);
+void EEPROM_WriteBufferChanged(const uint16_t address, const void *p_buffer, const unsigned int size);
 void EEPROM_WriteBuffer8(const uint16_t address, const void *p_buffer);
+#ifdef ENABLE_EEPROM_QUEUE
+	void EEPROM_process(void);
+	void EEPROM_flush(void);
+#endif
 
 #endif
 
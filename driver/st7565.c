@@ -16,7 +16,12 @@
 
 #include <stdint.h>
 #include <stdio.h>     // NULL
+#include <string.h>    // memcpy, memset
 
+#ifdef ENABLE_LCD_ASYNC_BLIT
+	#include "ARMCM0.h"
+	#include "bsp/dp32g030/irq.h"
+#endif
 #include "bsp/dp32g030/gpio.h"
 #include "bsp/dp32g030/spi.h"
 #include "driver/gpio.h"
@@ -32,6 +37,48 @@ uint8_t g_frame_buffer[7][128];
 	uint8_t contrast = 31;  // 0 ~ 63
 #endif
 
+#ifdef ENABLE_LCD_PARTIAL_BLIT
+	// a copy of what's been sent to the LCD, so a blit only needs to send the columns that have changed
+	//
+	// the display settings used to be re-sent on every blit (RF can corrupt them), that's now
+	// done from the 500ms time slice instead, with the whole screen re-sent every few seconds
+
+	#define ST7565_REDRAW_500ms   (4000 / 500)
+
+	static uint8_t      st7565_shown[1 + ARRAY_SIZE(g_frame_buffer)][128];   // [0] = status line
+	static uint8_t      st7565_shown_valid;                                   // a bit per line, 0 = send all of it next time
+	static unsigned int st7565_redraw_count;
+#endif
+
+#ifdef ENABLE_LCD_ASYNC_BLIT
+	// a blit only queues up the spans of columns to send and returns, the bytes themselves come
+	// straight out of st7565_shown (which already holds the new screen) and are fed to the SPI
+	// FIFO from the main loop, the FIFO's interrupt being used to wake the CPU when it wants more
+	//
+	// this is done from the main loop rather than the interrupt because A0 has to be flipped between
+	// the command and data bytes, and GPIOB is also written (read-modify-write) elsewhere
+	//
+	// the UI is free to draw the next screen as soon as the blit returns, anything that talks to
+	// the LCD directly waits for the queue to empty first
+
+	#define ST7565_SPANS   16   // power of 2
+
+	typedef struct {
+		uint8_t line;
+		uint8_t column;
+		uint8_t end;
+	} st7565_span_t;
+
+	static st7565_span_t st7565_spans[ST7565_SPANS];
+	static unsigned int  st7565_span_rd;
+	static unsigned int  st7565_span_wr;
+	static unsigned int  st7565_column;     // next column to send of the span at st7565_span_rd
+	static bool          st7565_selected;   // its line and column have been sent
+	static bool          st7565_sending;    // the LCD is selected (SSN)
+
+	void HandlerSPI0(void);
+#endif
+
 static void ST7565_WriteByte(uint8_t Value);
 
 static inline void ST7565_LowLevelWrite(uint8_t Value)
@@ -45,6 +92,10 @@ void ST7565_DrawLine(const unsigned int Column, const unsigned int Line, const u
 {
 	unsigned int i;
 
+	#ifdef ENABLE_LCD_ASYNC_BLIT
+		ST7565_Flush();
+	#endif
+
 	SPI_ToggleMasterMode(&SPI0->CR, false);
 
 	ST7565_SelectColumnAndLine(Column + 4U, Line);
@@ -69,22 +120,200 @@ void ST7565_DrawLine(const unsigned int Column, const unsigned int Line, const u
 	SPI_WaitForUndocumentedTxFifoStatusBit();
 
 	SPI_ToggleMasterMode(&SPI0->CR, true);
+
+	#ifdef ENABLE_LCD_PARTIAL_BLIT
+		for (i = 0; i < Size && (Column + i) < ARRAY_SIZE(st7565_shown[0]); i++)
+			st7565_shown[Line][Column + i] = (pBitmap != NULL) ? pBitmap[i] : 0;
+	#endif
 }
 
+#ifdef ENABLE_LCD_ASYNC_BLIT
+	static bool ST7565_TxDone(void)
+	{	// the FIFO is empty and the last byte has gone (the undocumented bit, see SPI_WaitForUndocumentedTxFifoStatusBit)
+		return (SPI0->FIFOST & SPI_FIFOST_TFE_MASK) == SPI_FIFOST_TFE_BITS_EMPTY && (SPI0->IF & 0x20) == 0;
+	}
+
+	void HandlerSPI0(void)
+	{	// just wakes up the main loop to feed the FIFO
+		SPI0->IE = 0;
+	}
+
+	void ST7565_Process(void)
+	{	// called from the main loop, keep the SPI FIFO fed from the span queue
+
+		uint32_t wake = 0;
+
+		while (st7565_span_rd != st7565_span_wr)
+		{
+			const st7565_span_t *span  = &st7565_spans[st7565_span_rd % ST7565_SPANS];
+			const uint8_t       *shown = st7565_shown[span->line];
+
+			if (!st7565_selected)
+			{	// A0 can't be changed until the last byte has gone
+				if (!ST7565_TxDone())
+				{
+					wake = SPI_IE_TXFIFO_EMPTY_MASK;
+					break;
+				}
+
+				GPIO_ClearBit(&GPIOB->DATA, GPIOB_PIN_ST7565_A0);
+
+				if (!st7565_sending)
+				{
+					SPI_ToggleMasterMode(&SPI0->CR, false);
+					ST7565_LowLevelWrite(0x40);    // start line ?
+					st7565_sending = true;
+				}
+
+				ST7565_LowLevelWrite(span->line + 0xB0);
+				ST7565_LowLevelWrite((((4u + span->column) >> 4) & 0x0F) | 0x10);
+				ST7565_LowLevelWrite(((4u + span->column) >> 0) & 0x0F);
+
+				st7565_column   = span->column;
+				st7565_selected = true;
+				continue;
+			}
+
+			if (!GPIO_CheckBit(&GPIOB->DATA, GPIOB_PIN_ST7565_A0))
+			{
+				if (!ST7565_TxDone())
+				{
+					wake = SPI_IE_TXFIFO_EMPTY_MASK;
+					break;
+				}
+				GPIO_SetBit(&GPIOB->DATA, GPIOB_PIN_ST7565_A0);
+			}
+
+			while (st7565_column < span->end && (SPI0->FIFOST & SPI_FIFOST_TFF_MASK) == SPI_FIFOST_TFF_BITS_NOT_FULL)
+				SPI0->WDR = shown[st7565_column++];
+
+			if (st7565_column < span->end)
+			{	// FIFO's full, come back when it's half empty
+				wake = SPI_IE_TXFIFO_HFULL_MASK;
+				break;
+			}
+
+			st7565_selected = false;
+			st7565_span_rd++;
+		}
+
+		if (st7565_span_rd == st7565_span_wr && st7565_sending)
+		{	// all sent, release the LCD once the last byte has gone
+			if (ST7565_TxDone())
+			{
+				SPI_ToggleMasterMode(&SPI0->CR, true);
+				st7565_sending = false;
+			}
+			else
+				wake = SPI_IE_TXFIFO_EMPTY_MASK;
+		}
+
+		SPI0->IE = wake;
+	}
+
+	bool ST7565_Pending(void)
+	{	// there's more to send and the SPI interrupt isn't going to wake us up for it
+		return (st7565_span_rd != st7565_span_wr || st7565_sending) && SPI0->IE == 0;
+	}
+
+	void ST7565_Flush(void)
+	{	// wait for everything queued to be sent
+		while (st7565_span_rd != st7565_span_wr || st7565_sending)
+			ST7565_Process();
+	}
+
+	static void ST7565_QueueSpan(const unsigned int Line, const unsigned int Column, const unsigned int end)
+	{
+		st7565_span_t *span;
+
+		while ((st7565_span_wr - st7565_span_rd) >= ST7565_SPANS)
+			ST7565_Process();   // full, wait for room
+
+		span         = &st7565_spans[st7565_span_wr % ST7565_SPANS];
+		span->line   = Line;
+		span->column = Column;
+		span->end    = end;
+		st7565_span_wr++;
+	}
+#endif
+
+#ifdef ENABLE_LCD_PARTIAL_BLIT
+	static void ST7565_BlitLine(const unsigned int Line, const uint8_t *pLine)
+	{	// send the parts of the line that differ from what's on the LCD
+
+		uint8_t     *shown  = st7565_shown[Line];
+		const bool   valid  = (st7565_shown_valid & (1u << Line)) ? true : false;
+		unsigned int Column = 0;
+
+		while (Column < ARRAY_SIZE(st7565_shown[0]))
+		{
+			unsigned int end;
+			unsigned int i;
+
+			if (valid && pLine[Column] == shown[Column])
+			{
+				Column++;
+				continue;
+			}
+
+			// carry the span on over unchanged gaps shorter than the 3 bytes it takes to start a new one
+			for (i = end = Column + 1; i < ARRAY_SIZE(st7565_shown[0]) && i < (end + 3); i++)
+				if (!valid || pLine[i] != shown[i])
+					end = i + 1;
+
+			#ifdef ENABLE_LCD_ASYNC_BLIT
+				memcpy(&shown[Column], &pLine[Column], end - Column);
+				ST7565_QueueSpan(Line, Column, end);
+			#else
+				ST7565_SelectColumnAndLine(4 + Column, Line);
+				GPIO_SetBit(&GPIOB->DATA, GPIOB_PIN_ST7565_A0);
+				for (i = Column; i < end; i++)
+				{
+					ST7565_LowLevelWrite(pLine[i]);
+					shown[i] = pLine[i];
+				}
+				SPI_WaitForUndocumentedTxFifoStatusBit();
+			#endif
+
+			Column = end;
+		}
+
+		st7565_shown_valid |= 1u << Line;
+	}
+
+	void ST7565_Refresh(void)
+	{	// called every 500ms
+		ST7565_Init(false);
+
+		if (++st7565_redraw_count >= ST7565_REDRAW_500ms)
+		{
+			st7565_redraw_count = 0;
+			st7565_shown_valid  = 0;
+		}
+	}
+#endif
+
 void ST7565_BlitFullScreen(void)
 {
 	unsigned int Line;
 
-	// reset some of the displays settings to try and overcome the
-	// radios hardware problem - RF corrupting the display
-	ST7565_Init(false);
+	#ifndef ENABLE_LCD_PARTIAL_BLIT
+		// reset some of the displays settings to try and overcome the
+		// radios hardware problem - RF corrupting the display
+		ST7565_Init(false);
+	#endif
 
-	SPI_ToggleMasterMode(&SPI0->CR, false);
+	#ifndef ENABLE_LCD_ASYNC_BLIT
+		SPI_ToggleMasterMode(&SPI0->CR, false);
 
-	ST7565_WriteByte(0x40);
+		ST7565_WriteByte(0x40);
+	#endif
 
 	for (Line = 0; Line < ARRAY_SIZE(g_frame_buffer); Line++)
 	{
+	#ifdef ENABLE_LCD_PARTIAL_BLIT
+		ST7565_BlitLine(Line + 1, g_frame_buffer[Line]);
+	#else
 		unsigned int Column;
 		ST7565_SelectColumnAndLine(4, Line + 1);
 		GPIO_SetBit(&GPIOB->DATA, GPIOB_PIN_ST7565_A0);
@@ -93,6 +322,7 @@ void ST7565_BlitFullScreen(void)
                     ST7565_LowLevelWrite(g_frame_buffer[Line][Column]);
 		}
 		SPI_WaitForUndocumentedTxFifoStatusBit();
+	#endif
 	}
 
 	#if 0
@@ -102,30 +332,46 @@ void ST7565_BlitFullScreen(void)
 //		SYSTEM_DelayMs(1);
 	#endif
 
-	SPI_ToggleMasterMode(&SPI0->CR, true);
+	#ifdef ENABLE_LCD_ASYNC_BLIT
+		ST7565_Process();   // make a start on it
+	#else
+		SPI_ToggleMasterMode(&SPI0->CR, true);
+	#endif
 }
 
 void ST7565_BlitStatusLine(void)
 {	// the top small text line on the display
 
-	unsigned int i;
+	#ifndef ENABLE_LCD_PARTIAL_BLIT
+		unsigned int i;
+	#endif
 
-	SPI_ToggleMasterMode(&SPI0->CR, false);
+	#ifndef ENABLE_LCD_ASYNC_BLIT
+		SPI_ToggleMasterMode(&SPI0->CR, false);
 
-	ST7565_WriteByte(0x40);    // start line ?
+		ST7565_WriteByte(0x40);    // start line ?
+	#endif
 
-	ST7565_SelectColumnAndLine(4, 0);
+	#ifdef ENABLE_LCD_PARTIAL_BLIT
+		ST7565_BlitLine(0, g_status_line);
+	#else
+		ST7565_SelectColumnAndLine(4, 0);
 
-	GPIO_SetBit(&GPIOB->DATA, GPIOB_PIN_ST7565_A0);
+		GPIO_SetBit(&GPIOB->DATA, GPIOB_PIN_ST7565_A0);
 
-	for (i = 0; i < ARRAY_SIZE(g_status_line); i++)
-	{
-                ST7565_LowLevelWrite(g_status_line[i]);
-	}
+		for (i = 0; i < ARRAY_SIZE(g_status_line); i++)
+		{
+			ST7565_LowLevelWrite(g_status_line[i]);
+		}
 
-	SPI_WaitForUndocumentedTxFifoStatusBit();
+		SPI_WaitForUndocumentedTxFifoStatusBit();
+	#endif
 
-	SPI_ToggleMasterMode(&SPI0->CR, true);
+	#ifdef ENABLE_LCD_ASYNC_BLIT
+		ST7565_Process();
+	#else
+		SPI_ToggleMasterMode(&SPI0->CR, true);
+	#endif
 }
 
 void ST7565_FillScreen(const uint8_t Value)
@@ -134,7 +380,7 @@ void ST7565_FillScreen(const uint8_t Value)
 
 	// reset some of the displays settings to try and overcome the
 	// radios hardware problem - RF corrupting the display
-	ST7565_Init(false);
+	ST7565_Init(false);   // also waits for any queued blit to finish
 
 	SPI_ToggleMasterMode(&SPI0->CR, false);
 
@@ -151,6 +397,11 @@ void ST7565_FillScreen(const uint8_t Value)
 	}
 
 	SPI_ToggleMasterMode(&SPI0->CR, true);
+
+	#ifdef ENABLE_LCD_PARTIAL_BLIT
+		memset(st7565_shown, Value, sizeof(st7565_shown));
+		st7565_shown_valid = (1u << ARRAY_SIZE(st7565_shown)) - 1;
+	#endif
 }
 
 void ST7565_Init(const bool full)
@@ -159,7 +410,14 @@ void ST7565_Init(const bool full)
 	{
 		SPI0_Init();
 		ST7565_HardwareReset();
+		#ifdef ENABLE_LCD_ASYNC_BLIT
+			NVIC_EnableIRQ((IRQn_Type)DP32_SPI0_IRQn);   // the FIFO wakes the main loop to feed it
+		#endif
 	}
+	#ifdef ENABLE_LCD_ASYNC_BLIT
+		else
+			ST7565_Flush();
+	#endif
 
 	SPI_ToggleMasterMode(&SPI0->CR, false);
 
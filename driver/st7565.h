@@ -29,6 +29,14 @@ extern uint8_t g_frame_buffer[7][128];
 void    ST7565_DrawLine(const unsigned int Column, const unsigned int Line, const unsigned int Size, const uint8_t *pBitmap);
 void    ST7565_BlitFullScreen(void);
 void    ST7565_BlitStatusLine(void);
+#ifdef ENABLE_LCD_PARTIAL_BLIT
+	void    ST7565_Refresh(void);
+#endif
+#ifdef ENABLE_LCD_ASYNC_BLIT
+	void    ST7565_Process(void);
+	bool    ST7565_Pending(void);
+	void    ST7565_Flush(void);
+#endif
 void    ST7565_FillScreen(const uint8_t Value);
 void    ST7565_Init(const bool full);
 void    ST7565_HardwareReset(void);
@@ -17,6 +17,7 @@
 #include "ARMCM0.h"
 #include "driver/systick.h"
 #include "misc.h"
+#include "scheduler.h"
 
 // 0x20000324
 static uint32_t gTickMultiplier;
@@ -47,3 +48,16 @@ void SYSTICK_Delay250ns(const uint32_t Delay)
 
 	} while (i < ticks);
 }
+
+uint32_t SYSTICK_get_us(void)
+{	// microseconds since power-on (wraps every 71 minutes), the 10ms tick count plus how far into the current tick we are
+	uint32_t ticks;
+	uint32_t count;
+
+	do {	// make sure the tick count didn't change while reading the counter
+		ticks = SCHEDULER_ticks();
+		count = SysTick->VAL;
+	} while (ticks != SCHEDULER_ticks());
+
+	return (ticks * 10000u) + ((SysTick->LOAD - count) / gTickMultiplier);
+}
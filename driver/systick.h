@@ -19,8 +19,9 @@
 
 #include <stdint.h>
 
-void SYSTICK_Init(void);
-void SYSTICK_Delay250ns(const uint32_t Delay);
+void     SYSTICK_Init(void);
+void     SYSTICK_Delay250ns(const uint32_t Delay);
+uint32_t SYSTICK_get_us(void);
 
 #endif
 
@@ -93,6 +93,17 @@ void UART_Send(const void *pBuffer, uint32_t Size)
 	}
 }
 
+uint32_t UART_SendSome(const void *pBuffer, uint32_t Size)
+{	// only what the TX FIFO will take without waiting, returns how many bytes went
+	const uint8_t *pData = (const uint8_t *)pBuffer;
+	uint32_t       i     = 0;
+
+	while (i < Size && (UART1->IF & UART_IF_TXFIFO_FULL_MASK) == UART_IF_TXFIFO_FULL_BITS_NOT_SET)
+		UART1->TDR = pData[i++];
+
+	return i;
+}
+
 void UART_SendText(const void *str)
 {
 	if (str)
@@ -121,6 +132,11 @@ void UART_printf(const char *str, ...)
 		len = vsnprintf(text, sizeof(text), str, va);
 	va_end(va);
 
+	if (len < 0)
+		return;
+	if (len >= (int)sizeof(text))
+		len = sizeof(text) - 1;   // it's been cut short
+
 	UART_Send(text, len);
 	//UART_Send(text, strlen(text));
 }
@@ -1,176 +1,384 @@
+#include <string.h>     // memcpy, memmove, memset
 
 #if defined(ENABLE_UART) && defined(ENABLE_UART_DEBUG)
 	#include "driver/uart.h"
 #endif
+#include "driver/eeprom.h"
 #include "freq_ignore.h"
 #include "misc.h"
+#include "settings.h"
+
+// a list of frequency ranges to ignore/skip when scanning
+//
+// it's kept in the otherwise unused eeprom block at 0x1D00 (so it survives power off), and
+// is used straight out of the g_eeprom copy in RAM
+//
+// byte 0 is the number of list bytes that follow (0xff = empty list), the list being sorted
+// ranges stored as two variable length values each (7 bits per byte, bit-7 set = more to come) ..
+//
+//   gap   = lower frequency - the previous range's upper frequency (0 before the first range)
+//   width = upper frequency - lower frequency
+//
+// so a single frequency typically takes 3 or 4 bytes rather than 8
+
+#define FI_MAX_SIZE   (sizeof(g_eeprom.scan_ignore) - 2)   // so the byte count can never be read as 0xff
+
+typedef struct {
+	unsigned int index;       // range number
+	unsigned int pos;         // list position of the range
+	unsigned int next;        // list position of the range after it
+	uint32_t     prev_upper;  // upper frequency of the range before it
+	uint32_t     lower;
+	uint32_t     upper;
+} fi_cursor_t;
+
+// where the last look-up ended up, a scan only ever moves it on (or back) a range at a time
+static fi_cursor_t fi_cursor;
+
+static unsigned int FI_length(void)
+{
+	unsigned int length;
+
+	#ifdef ENABLE_EEPROM_LAZY_LOAD
+		SETTINGS_load((unsigned int)(g_eeprom.scan_ignore - (uint8_t *)&g_eeprom), sizeof(g_eeprom.scan_ignore));
+	#endif
 
-//#define FI_CLOSE_ENOUGH_HZ   300
+	length = g_eeprom.scan_ignore[0];
+	return (length > FI_MAX_SIZE) ? 0 : length;
+}
 
-// a list of frequencies to ignore/skip when scanning
-uint32_t ignore_frequencies[64];
-int      ignore_frequencies_count = 0;
+static unsigned int FI_get_value(unsigned int pos, const unsigned int length, uint32_t *value)
+{	// returns the position after the value, or 0 if it's broken
+	const uint8_t *list  = &g_eeprom.scan_ignore[1];
+	uint32_t       val   = 0;
+	unsigned int   shift = 0;
 
-void FI_clear_freq_ignored(void)
-{	// clear the ignore list
-	ignore_frequencies_count = 0;
+	while (pos < length && shift < 32)
+	{
+		const uint8_t data = list[pos++];
+		val |= (uint32_t)(data & 0x7f) << shift;
+		if ((data & 0x80) == 0)
+		{
+			*value = val;
+			return pos;
+		}
+		shift += 7;
+	}
 
-	#if defined(ENABLE_UART) && defined(ENABLE_UART_DEBUG)
-		UART_SendText("ignore cleared\r\n");
-	#endif
+	return 0;
 }
 
-int FI_freq_ignored(const uint32_t frequency)
-{	// return index of the ignored frequency
-
-	#ifdef FI_CLOSE_ENOUGH_HZ
-		if (frequency <= FI_CLOSE_ENOUGH_HZ || frequency >= (0xffffffff - FI_CLOSE_ENOUGH_HZ) || ignore_frequencies_count <= 0)
-			return -1;   // invalid frequency
-	#else
-		if (frequency == 0 || frequency == 0xffffffff || ignore_frequencies_count <= 0)
-			return -1;   // invalid frequency
-	#endif
+static unsigned int FI_put_value(uint8_t *p, uint32_t value)
+{	// returns the number of bytes used
+	unsigned int size = 0;
+	while (value >= 0x80)
+	{
+		p[size++] = (value & 0x7f) | 0x80;
+		value >>= 7;
+	}
+	p[size++] = value;
+	return size;
+}
+
+static void FI_cursor_start(fi_cursor_t *cursor)
+{
+	memset(cursor, 0, sizeof(*cursor));
+}
+
+static bool FI_cursor_read(fi_cursor_t *cursor, const unsigned int length)
+{	// decode the range the cursor is sat on
+	uint32_t     gap;
+	uint32_t     width;
+	unsigned int pos;
 
-	if (ignore_frequencies_count >= 20)
-	{	// binary search becomes faster than sequencial as the list grows beyound a certain size
-		int low = 0;
-		int high = ignore_frequencies_count;
+	if (cursor->pos >= length)
+		return false;
 
-		while (low < high)
+	pos = FI_get_value(cursor->pos, length, &gap);
+	if (pos == 0)
+		return false;
+	pos = FI_get_value(pos, length, &width);
+	if (pos == 0)
+		return false;
+
+	cursor->lower = cursor->prev_upper + gap;
+	cursor->upper = cursor->lower + width;
+	cursor->next  = pos;
+
+	return true;
+}
+
+static void FI_cursor_step(fi_cursor_t *cursor)
+{
+	cursor->prev_upper = cursor->upper;
+	cursor->pos        = cursor->next;
+	cursor->index++;
+}
+
+static unsigned int FI_value_start(unsigned int end)
+{	// back up from just after a value to its first byte .. all but the last byte of a value have bit-7 set
+	const uint8_t *list = &g_eeprom.scan_ignore[1];
+
+	if (end == 0)
+		return 0;
+
+	end--;
+	while (end > 0 && (list[end - 1] & 0x80))
+		end--;
+
+	return end;
+}
+
+static bool FI_cursor_back(fi_cursor_t *cursor, const unsigned int length)
+{	// move the cursor back onto the range before it, decoding that range backwards
+	unsigned int gap_pos;
+	unsigned int width_pos;
+	uint32_t     gap;
+	uint32_t     width;
+
+	if (cursor->index == 0 || cursor->pos > length)
+		return false;
+
+	width_pos = FI_value_start(cursor->pos);
+	gap_pos   = FI_value_start(width_pos);
+
+	if (width_pos == 0 ||
+	    FI_get_value(gap_pos,   length, &gap)   != width_pos ||
+	    FI_get_value(width_pos, length, &width) != cursor->pos)
+		return false;
+
+	cursor->next       = cursor->pos;
+	cursor->pos        = gap_pos;
+	cursor->upper      = cursor->prev_upper;
+	cursor->lower      = cursor->upper - width;
+	cursor->prev_upper = cursor->lower - gap;
+	cursor->index--;
+
+	return true;
+}
+
+#if defined(ENABLE_UART) && defined(ENABLE_UART_DEBUG)
+	static void FI_print_list(void)
+	{
+		const unsigned int length = FI_length();
+		fi_cursor_t        cursor;
+
+		FI_cursor_start(&cursor);
+		while (FI_cursor_read(&cursor, length))
 		{
-			register int mid  = (low + high) / 2;
-			register uint32_t freq = ignore_frequencies[mid];
-
-			#ifdef FI_CLOSE_ENOUGH_HZ
-				if (abs((int32_t)frequency - (int32_t)freq) <= FI_CLOSE_ENOUGH_HZ)
-			#else
-				if (frequency == freq)
-			#endif
-			{	// found it
-				#if defined(ENABLE_UART) && defined(ENABLE_UART_DEBUG)
-					UART_printf("ignored bin %u %u\r\n", frequency, mid);
-				#endif
-				return mid;
-			}
-
-			if (freq > frequency)
-				high = mid;
-			else
-				low  = mid + 1;
+			UART_printf("%2u %10u %10u\r\n", cursor.index, cursor.lower, cursor.upper);
+			FI_cursor_step(&cursor);
 		}
+		UART_printf("ignore size %u\r\n", length);
 	}
-	else
-	{	// sequencial search
-		register int i;
-		for (i = 0; i < ignore_frequencies_count; i++)
-		{
-			register uint32_t freq = ignore_frequencies[i];
-
-			#ifdef FI_CLOSE_ENOUGH_HZ
-				if (abs((int32_t)frequency - (int32_t)freq) <= FI_CLOSE_ENOUGH_HZ)
-			#else
-				if (frequency == freq)
-			#endif
-			{	// found it
-				#if defined(ENABLE_UART) && defined(ENABLE_UART_DEBUG)
-					UART_printf("ignored seq %u %u\r\n", frequency, i);
-				#endif
-				return i;
-			}
-
-			if (frequency < freq)
-				return -1;        // exit loop early as the list is sorted by frequency
+#endif
+
+static bool FI_find(const uint32_t frequency)
+{	// leave the cursor on the first range that doesn't end below 'frequency'
+
+	const unsigned int length = FI_length();
+
+	while (frequency <= fi_cursor.prev_upper)
+	{	// it's behind us, walk back down
+		if (!FI_cursor_back(&fi_cursor, length))
+		{	// start again from the bottom
+			FI_cursor_start(&fi_cursor);
+			break;
 		}
 	}
 
-	return -1;    // not found
+	while (FI_cursor_read(&fi_cursor, length))
+	{
+		if (fi_cursor.upper >= frequency)
+			return (fi_cursor.lower <= frequency);
+		FI_cursor_step(&fi_cursor);
+	}
+
+	return false;
 }
 
-bool FI_add_freq_ignored(const uint32_t frequency)
-{	// add a new frequency to the ignore list
+static bool FI_replace(const unsigned int from, const unsigned int to, const uint8_t *data, const unsigned int size)
+{	// replace list bytes 'from' to 'to' with 'data', then save the changes
+
+	uint8_t           *list       = &g_eeprom.scan_ignore[1];
+	const unsigned int index      = (unsigned int)(g_eeprom.scan_ignore - (uint8_t *)&g_eeprom);
+	const unsigned int length     = FI_length();
+	const unsigned int new_length = length - (to - from) + size;
+	const unsigned int end        = 1 + ((new_length > length) ? new_length : length);
+
+	if (new_length > FI_MAX_SIZE)
+	{	// the list is full
+		#if defined(ENABLE_UART) && defined(ENABLE_UART_DEBUG)
+			UART_SendText("ignore full\r\n");
+		#endif
+		return false;
+	}
+
+	memmove(list + from + size, list + to, length - to);
+	if (size > 0)
+		memcpy(list + from, data, size);
+	if (new_length < length)
+		memset(list + new_length, 0xff, length - new_length);
 
-	int i;
+	g_eeprom.scan_ignore[0] = (new_length == 0) ? 0xff : new_length;
+
+	FI_cursor_start(&fi_cursor);
+
+	// save the count and everything from the change onwards (unchanged bytes are skipped by the eeprom driver)
+	EEPROM_WriteBuffer(index, g_eeprom.scan_ignore, 1);
+	EEPROM_WriteBuffer(index + 1 + from, g_eeprom.scan_ignore + 1 + from, end - (1 + from));
 
 	#if defined(ENABLE_UART) && defined(ENABLE_UART_DEBUG)
-		UART_printf("ignore add %u\r\n", frequency);
+		FI_print_list();
 	#endif
 
-	#ifdef FI_CLOSE_ENOUGH_HZ
-		if (frequency <= FI_CLOSE_ENOUGH_HZ || frequency >= (0xffffffff - FI_CLOSE_ENOUGH_HZ))
-			return false;   // invalid frequency
-	#else
-		if (frequency == 0 || frequency == 0xffffffff)
-			return false;   // invalid frequency
+	return true;
+}
+
+void FI_clear_freq_ignored(void)
+{	// clear the ignore list
+	FI_replace(0, FI_length(), NULL, 0);
+
+	#if defined(ENABLE_UART) && defined(ENABLE_UART_DEBUG)
+		UART_SendText("ignore cleared\r\n");
 	#endif
+}
 
-	if (ignore_frequencies_count >= (int)ARRAY_SIZE(ignore_frequencies))
-	{	// the list is full
-		#if defined(ENABLE_UART) && defined(ENABLE_UART_DEBUG)
-			UART_SendText("ignore add full\r\n");
-		#endif
-		return false;  // failed
-	}
+int FI_freq_ignored(const uint32_t frequency)
+{	// return index of the ignored range the frequency is in
+
+	if (frequency == 0 || frequency == 0xffffffff)
+		return -1;   // invalid frequency
+
+	return FI_find(frequency) ? (int)fi_cursor.index : -1;
+}
+
+bool FI_freq_ignored_range(const uint32_t frequency, uint32_t *lower, uint32_t *upper)
+{	// return the edges of the ignored range the frequency is in
+
+	if (FI_freq_ignored(frequency) < 0)
+		return false;
+
+	*lower = fi_cursor.lower;
+	*upper = fi_cursor.upper;
+
+	return true;
+}
+
+static bool FI_add_range(uint32_t lower, uint32_t upper, const uint32_t join)
+{	// add a range, merging it with any ranges within 'join' of it
+
+	const unsigned int length = FI_length();
+	fi_cursor_t        cursor;
+	unsigned int       from;
+	unsigned int       to;
+	uint32_t           prev_upper;
+	uint8_t            data[20];
+	unsigned int       size;
+
+	// skip the ranges that end well below the new one
+	FI_cursor_start(&cursor);
+	while (FI_cursor_read(&cursor, length) && (cursor.upper + join) < lower)
+		FI_cursor_step(&cursor);
 
-	for (i = 0; i < ignore_frequencies_count; i++)
+	from       = cursor.pos;
+	prev_upper = cursor.prev_upper;
+
+	// swallow the ranges the new one overlaps or comes close to
+	while (FI_cursor_read(&cursor, length) && cursor.lower <= (upper + join))
 	{
-		register uint32_t freq = ignore_frequencies[i];
+		if (lower > cursor.lower)
+			lower = cursor.lower;
+		if (upper < cursor.upper)
+			upper = cursor.upper;
+		FI_cursor_step(&cursor);
+	}
 
-		#ifdef FI_CLOSE_ENOUGH_HZ
-			if (abs((int32_t)frequency - (int32_t)freq) <= FI_CLOSE_ENOUGH_HZ)
-		#else
-			if (frequency == freq)
-		#endif
-		{	// already in the list
-			#if defined(ENABLE_UART) && defined(ENABLE_UART_DEBUG)
-				UART_SendText("ignore add already\r\n");
-			#endif
-			return true;
-		}
+	to = cursor.pos;
 
-		#ifdef FI_CLOSE_ENOUGH_HZ
-			if (frequency < (freq + FI_CLOSE_ENOUGH_HZ))
-				break;        // exit loop early as the list is sorted by frequency
-		#else
-			if (frequency < freq)
-				break;        // exit loop early as the list is sorted by frequency
-		#endif
+	size  = FI_put_value(data, lower - prev_upper);
+	size += FI_put_value(data + size, upper - lower);
+
+	if (FI_cursor_read(&cursor, length))
+	{	// the range after it is now a different distance away
+		size += FI_put_value(data + size, cursor.lower - upper);
+		size += FI_put_value(data + size, cursor.upper - cursor.lower);
+		to    = cursor.next;
 	}
 
-	// found the location to store the new frequency - the list is kept sorted by frequency
+	return FI_replace(from, to, data, size);
+}
 
-	// make room for the new frequency
-	if (i < ignore_frequencies_count)
-		memmove(&ignore_frequencies[i + 1], &ignore_frequencies[i], sizeof(ignore_frequencies[0]) * (ignore_frequencies_count - i));
+bool FI_add_range_ignored(const uint32_t lower, const uint32_t upper)
+{	// add a new range to the ignore list
 
-	// add the frequency to the list
-	ignore_frequencies[i] = frequency;
-	ignore_frequencies_count++;
+	#if defined(ENABLE_UART) && defined(ENABLE_UART_DEBUG)
+		UART_printf("ignore add %u %u\r\n", lower, upper);
+	#endif
+
+	if (lower == 0 || upper == 0xffffffff || lower > upper)
+		return false;   // invalid range
+
+	return FI_add_range(lower, upper, 1);
+}
+
+bool FI_add_freq_ignored(const uint32_t frequency)
+{	// add a new frequency to the ignore list
 
 	#if defined(ENABLE_UART) && defined(ENABLE_UART_DEBUG)
-		for (i = 0; i < ignore_frequencies_count; i++)
-			UART_printf("%2u %10u\r\n", i, ignore_frequencies[i]);
+		UART_printf("ignore add %u\r\n", frequency);
 	#endif
 
-	return true;
+	if (frequency == 0 || frequency == 0xffffffff)
+		return false;   // invalid frequency
+
+	// join it onto a range it's one scan step away from, so ignoring a run of
+	// neighbouring steps leaves one range that the scan can jump over in one go
+	return FI_add_range(frequency, frequency, (g_scan_initial_step_size > 0) ? g_scan_initial_step_size : 1);
 }
 
 void FI_sub_freq_ignored(const uint32_t frequency)
-{	// remove a frequency from the ignore list
+{	// remove the range the frequency is in from the ignore list
+
+	const unsigned int length = FI_length();
+	fi_cursor_t        cursor;
+	unsigned int       from;
+	unsigned int       to;
+	uint32_t           prev_upper;
+	uint8_t            data[10];
+	unsigned int       size  = 0;
+	bool               found = false;
 
 	#if defined(ENABLE_UART) && defined(ENABLE_UART_DEBUG)
 		UART_printf("ignore sub %u\r\n", frequency);
 	#endif
 
-	int index = FI_freq_ignored(frequency);
-	if (index < 0)
-		return;
+	FI_cursor_start(&cursor);
+	while (FI_cursor_read(&cursor, length))
+	{
+		if (cursor.upper >= frequency)
+		{
+			found = (cursor.lower <= frequency);
+			break;
+		}
+		FI_cursor_step(&cursor);
+	}
+
+	if (!found)
+		return;   // not in the list
 
-	if (index < (ignore_frequencies_count - 1))
-		memmove(&ignore_frequencies[index], &ignore_frequencies[index + 1], sizeof(ignore_frequencies[0]) * (ignore_frequencies_count - 1));
-	ignore_frequencies_count--;
+	from       = cursor.pos;
+	prev_upper = cursor.prev_upper;
 
-	#if defined(ENABLE_UART) && defined(ENABLE_UART_DEBUG)
-		for (index = 0; index < ignore_frequencies_count; index++)
-			UART_printf("%2u %10u\r\n", index, ignore_frequencies[index]);
-	#endif
+	FI_cursor_step(&cursor);
+	to = cursor.pos;
+
+	if (FI_cursor_read(&cursor, length))
+	{	// the range after it is now a different distance away
+		size  = FI_put_value(data, cursor.lower - prev_upper);
+		size += FI_put_value(data + size, cursor.upper - cursor.lower);
+		to    = cursor.next;
+	}
+
+	FI_replace(from, to, data, size);
 }
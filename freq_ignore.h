@@ -23,6 +23,8 @@
 #ifdef ENABLE_SCAN_IGNORE_LIST
 	void FI_clear_freq_ignored(void);
 	int  FI_freq_ignored(const uint32_t frequency);
+	bool FI_freq_ignored_range(const uint32_t frequency, uint32_t *lower, uint32_t *upper);
+	bool FI_add_range_ignored(const uint32_t lower, const uint32_t upper);
 	bool FI_add_freq_ignored(const uint32_t frequency);
 	void FI_sub_freq_ignored(const uint32_t frequency);
 #endif
@@ -71,11 +71,10 @@ void FUNCTION_Init(void)
 	g_squelch_open = false;
 
 	g_flag_tail_tone_elimination_complete = false;
-	g_tail_tone_elimination_tick_10ms     = 0;
+	SCHEDULER_stop(&g_tail_tone_elimination_timer);
 	g_found_ctcss                         = false;
 	g_found_cdcss                         = false;
-	g_found_ctcss_tick_10ms               = 0;
-	g_found_cdcss_tick_10ms               = 0;
+	SCHEDULER_stop(&g_found_ctcss_timer);
 	g_end_of_rx_detected_maybe            = false;
 
 	#ifdef ENABLE_NOAA
@@ -85,6 +84,11 @@ void FUNCTION_Init(void)
 	g_update_status = true;
 }
 
+static void FUNCTION_tx_timeout(void)
+{
+	g_tx_timeout_reached = true;
+}
+
 void FUNCTION_Select(function_type_t Function)
 {
 	const function_type_t prev_func = g_current_function;
@@ -179,7 +183,7 @@ void FUNCTION_Select(function_type_t Function)
 				UART_printf("func transmit %u\r\n", g_tx_vfo->freq_config_tx.frequency);
 			#endif
 
-			g_tx_timer_tick_500ms = 0;
+			SCHEDULER_stop(&g_tx_timer);
 			g_tx_timeout_reached  = false;
 			g_flag_end_tx         = false;
 
@@ -189,7 +193,7 @@ void FUNCTION_Select(function_type_t Function)
 				if (g_alarm_state == ALARM_STATE_OFF)
 			#endif
 			{
-				g_tx_timer_tick_500ms = tx_timeout_secs[g_eeprom.config.setting.tx_timeout] * 2;
+				SCHEDULER_start(&g_tx_timer, tx_timeout_secs[g_eeprom.config.setting.tx_timeout] * 100u, 0, FUNCTION_tx_timeout);
 			}
 
 			if (g_eeprom.config.setting.backlight_on_tx_rx == 1 || g_eeprom.config.setting.backlight_on_tx_rx == 3)
@@ -0,0 +1,56 @@
+/* Copyright 2023 One of Eleven
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef HOST_ARMCM0_H
+#define HOST_ARMCM0_H
+
+// stands in for the CMSIS ARMCM0.h when building for the host
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "host/sim.h"
+
+typedef int IRQn_Type;
+
+static inline void __disable_irq(void)
+{
+	SIM_irq_enable(false);
+}
+
+static inline void __enable_irq(void)
+{
+	SIM_irq_enable(true);
+}
+
+static inline void NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+	(void)IRQn;
+}
+
+static inline void NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+	(void)IRQn;
+}
+
+static inline void NVIC_SystemReset(void)
+{
+	fprintf(stderr, "sim: system reset\n");
+	exit(0);
+}
+
+#endif
@@ -0,0 +1,73 @@
+/* Copyright 2023 One of Eleven
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#include "driver/adc.h"
+#include "host/sim.h"
+#include "settings.h"
+
+uint8_t ADC_GetChannelNumber(ADC_CH_MASK Mask)
+{
+	uint8_t i;
+	for (i = 0; i < 16; i++)
+		if (Mask & (1u << i))
+			return i;
+	return 0;
+}
+
+void ADC_Disable(void)
+{
+}
+
+void ADC_Enable(void)
+{
+}
+
+void ADC_SoftReset(void)
+{
+}
+
+uint32_t ADC_GetClockConfig(void)
+{
+	return 0;
+}
+
+void ADC_Configure(ADC_Config_t *pAdc)
+{
+	(void)pAdc;
+}
+
+void ADC_Start(void)
+{
+	SIM_advance_ns(10000);
+}
+
+bool ADC_CheckEndOfConversion(ADC_CH_MASK Mask)
+{
+	(void)Mask;
+	return true;
+}
+
+uint16_t ADC_GetValue(ADC_CH_MASK Mask)
+{
+	if (Mask == ADC_CH4)
+	{	// battery voltage .. a healthy 8.0V according to the radios own calibration
+		const uint16_t cal = g_eeprom.calib.battery[3];
+		return (cal == 0 || cal == 0xffff) ? 2000 : (uint16_t)((cal * 800u) / 760u);
+	}
+
+	return 0;   // USB current
+}
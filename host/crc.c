@@ -0,0 +1,74 @@
+/* Copyright 2023 One of Eleven
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#include <stdbool.h>
+
+#include "driver/crc.h"
+
+// software version of the CRC peripheral (CRC-16/CCITT, zero initial value)
+
+#ifdef ENABLE_MDC1200
+	static bool reverse;
+#endif
+
+void CRC_Init(void)
+{
+	#ifdef ENABLE_MDC1200
+		reverse = false;
+	#endif
+}
+
+#ifdef ENABLE_MDC1200
+	void CRC_InitReverse(void)
+	{
+		reverse = true;
+	}
+#endif
+
+uint16_t CRC_Calculate(const void *buffer, const unsigned int size)
+{
+	const uint8_t *data = (const uint8_t *)buffer;
+	uint16_t       crc  = 0;
+	unsigned int   i;
+
+	for (i = 0; i < size; i++)
+	{
+		unsigned int k;
+		uint8_t      b = data[i];
+
+		#ifdef ENABLE_MDC1200
+			if (reverse)
+				b = ~b;
+		#endif
+
+		crc ^= (uint16_t)b << 8;
+		for (k = 0; k < 8; k++)
+			crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+	}
+
+	#ifdef ENABLE_MDC1200
+		if (reverse)
+		{	// output bit reversed and inverted
+			uint16_t r = 0;
+			for (i = 0; i < 16; i++)
+				r |= ((crc >> i) & 1u) << (15 - i);
+			crc = ~r;
+		}
+	#endif
+
+	return crc;
+}
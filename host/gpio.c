@@ -0,0 +1,73 @@
+/* Copyright 2023 One of Eleven
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include "bsp/dp32g030/gpio.h"
+#include "driver/gpio.h"
+#include "host/sim.h"
+
+// same as driver/gpio.c but lets the simulated chips see the pin activity
+
+static void GPIO_Changed(volatile uint32_t *pReg)
+{
+	if (pReg == &GPIOC->DATA)
+		SIM_bk4819_pins(*pReg);
+	else
+	if (pReg == &GPIOA->DATA)
+		SIM_eeprom_pins(*pReg);
+}
+
+void GPIO_ClearBit(volatile uint32_t *pReg, uint8_t Bit)
+{
+	*pReg &= ~(1U << Bit);
+	GPIO_Changed(pReg);
+}
+
+uint8_t GPIO_CheckBit(volatile uint32_t *pReg, uint8_t Bit)
+{
+	if (pReg == &GPIOC->DATA)
+	{
+		if (Bit == GPIOC_PIN_PTT)
+			return g_sim_ptt ? 0 : 1;   // active low
+
+		if (Bit == GPIOC_PIN_BK4819_SDA)
+		{
+			const int sda = SIM_bk4819_sda();
+			if (sda >= 0)
+				return sda;
+		}
+	}
+	else
+	if (pReg == &GPIOA->DATA && Bit == GPIOA_PIN_I2C_SDA)
+	{
+		const int sda = SIM_eeprom_sda();
+		if (sda >= 0)
+			return sda;
+	}
+
+	return (*pReg >> Bit) & 1U;
+}
+
+void GPIO_FlipBit(volatile uint32_t *pReg, uint8_t Bit)
+{
+	*pReg ^= 1U << Bit;
+	GPIO_Changed(pReg);
+}
+
+void GPIO_SetBit(volatile uint32_t *pReg, uint8_t Bit)
+{
+	*pReg |= 1U << Bit;
+	GPIO_Changed(pReg);
+}
@@ -0,0 +1,40 @@
+/* Copyright 2023 One of Eleven
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#include "driver/keyboard.h"
+#include "host/sim.h"
+
+int8_t     g_ptt_debounce;
+uint8_t    g_key_debounce_press;
+uint8_t    g_key_debounce_repeat;
+key_code_t g_key_prev    = KEY_INVALID;
+key_code_t g_key_pressed = KEY_INVALID;
+bool       g_key_held;
+bool       g_fkey_pressed;
+bool       g_ptt_is_pressed;
+
+bool       g_ptt_was_released;
+bool       g_ptt_was_pressed;
+uint8_t    g_keypad_locked;
+
+key_code_t KEYBOARD_Poll(void)
+{
+	// roughly what the real matrix scan with its de-noise delays costs
+	SIM_advance_ns(20000);
+
+	return g_sim_key;
+}
@@ -0,0 +1,264 @@
+/* Copyright 2023 One of Eleven
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef ENABLE_AM_FIX
+	#include "am_fix.h"
+#endif
+#include "app/app.h"
+#include "app/dtmf.h"
+#include "board.h"
+#include "driver/backlight.h"
+#ifdef ENABLE_FMRADIO
+	#include "driver/bk1080.h"
+#endif
+#include "driver/bk4819.h"
+#include "driver/crc.h"
+#ifdef ENABLE_EEPROM_QUEUE
+	#include "driver/eeprom.h"
+#endif
+#include "driver/st7565.h"
+#include "driver/systick.h"
+#if defined(ENABLE_UART)
+	#include "driver/uart.h"
+#endif
+#include "frequencies.h"
+#include "functions.h"
+#include "helper/battery.h"
+#include "host/sim.h"
+#ifdef ENABLE_MDC1200
+	#include "mdc1200.h"
+#endif
+#include "misc.h"
+#include "radio.h"
+#include "scheduler.h"
+#include "settings.h"
+#include "ui/menu.h"
+
+static void usage(const char *name)
+{
+	fprintf(stderr,
+		"usage: %s [-e eeprom.bin] [-w] [-s script.txt] [-t ms] [-u uart.bin] [-l] [-q]\n"
+		"  -e  8kB EEPROM image to boot with (blank if not given, or missing with -w)\n"
+		"  -w  write the EEPROM image back on exit\n"
+		"  -s  key/PTT/register/uart event script\n"
+		"  -t  simulated run time in ms (default 10000)\n"
+		"  -u  file to capture the UART TX output (default stdout)\n"
+		"  -l  dump the LCD on exit\n"
+		"  -q  don't print the run statistics\n",
+		name);
+}
+
+static void blank_eeprom(void)
+{	// no image given .. a factory fresh radio, 0xff's everywhere but with
+	// the settings zeroed (the firmware doesn't range check them) and a battery calibration
+	static const uint16_t battery[] = {1800, 1900, 1950, 2000, 2100, 2300};
+	t_eeprom    *eeprom = (t_eeprom *)g_sim_eeprom;
+	unsigned int vfo;
+
+	memset(g_sim_eeprom, 0xff, sizeof(g_sim_eeprom));
+	memset(&eeprom->config.setting, 0, sizeof(eeprom->config.setting));
+	memset(eeprom->config.vfo_channel, 0, sizeof(eeprom->config.vfo_channel));
+	for (vfo = 0; vfo < ARRAY_SIZE(eeprom->config.vfo_channel); vfo++)
+		eeprom->config.vfo_channel[vfo].frequency = FREQ_BAND_TABLE[(vfo / 2) % ARRAY_SIZE(FREQ_BAND_TABLE)].lower;
+	for (vfo = 0; vfo < 2; vfo++)
+	{	// both VFO's on the 400MHz band
+		eeprom->config.setting.indices.vfo[vfo].screen    = FREQ_CHANNEL_FIRST + BAND6_400MHz;
+		eeprom->config.setting.indices.vfo[vfo].user      = USER_CHANNEL_FIRST;
+		eeprom->config.setting.indices.vfo[vfo].frequency = FREQ_CHANNEL_FIRST + BAND6_400MHz;
+	}
+	memcpy(eeprom->calib.battery, battery, sizeof(eeprom->calib.battery));
+}
+
+static sched_timer_t time_slice_10ms;
+static sched_timer_t time_slice_40ms;
+static sched_timer_t time_slice_500ms;
+
+static void time_slice_10ms_due(void)
+{
+	APP_time_slice_10ms();
+	g_sim_stats.time_slices_10ms++;
+}
+
+static void time_slice_500ms_due(void)
+{
+	APP_time_slice_500ms();
+	g_sim_stats.time_slices_500ms++;
+}
+
+static void boot(void)
+{	// the same order as Main() in main.c, minus the boot screens and waiting for keys
+	unsigned int i;
+
+	SYSTICK_Init();
+
+	BOARD_PORTCON_Init();
+	BOARD_GPIO_Init();
+	CRC_Init();
+	#ifdef ENABLE_UART
+		UART_Init();
+	#endif
+	BOARD_ADC_Init();
+	BACKLIGHT_init();
+	ST7565_Init(true);
+	#ifdef ENABLE_FMRADIO
+		BK1080_Init(0, false);
+	#endif
+
+	SETTINGS_read_eeprom();
+
+	FREQUENCY_init();
+
+	BK4819_Init();
+
+	BOARD_ADC_GetBatteryInfo(&g_usb_current_voltage, &g_usb_current);
+
+	memset(g_dtmf_string, '-', sizeof(g_dtmf_string));
+	g_dtmf_string[sizeof(g_dtmf_string) - 1] = 0;
+
+	#ifdef ENABLE_MDC1200
+		MDC1200_init();
+	#endif
+
+	#ifdef ENABLE_AM_FIX
+		AM_fix_init();
+	#endif
+
+	BK4819_set_mic_gain(g_mic_sensitivity_tuning);
+
+	RADIO_configure_channel(0, VFO_CONFIGURE_RELOAD);
+	RADIO_configure_channel(1, VFO_CONFIGURE_RELOAD);
+	RADIO_select_vfos();
+	RADIO_setup_registers(true);
+
+	#ifdef ENABLE_SLICE_STATS
+		g_boot_rx_us = SYSTICK_get_us();
+	#endif
+
+	for (i = 0; i < ARRAY_SIZE(g_battery_voltages); i++)
+		BOARD_ADC_GetBatteryInfo(&g_battery_voltages[i], &g_usb_current);
+	BATTERY_GetReadings(false);
+
+	UI_SortMenu(!g_unhide_hidden);
+
+	BACKLIGHT_turn_on(0);
+
+	g_update_status  = true;
+	g_update_display = true;
+}
+
+int main(int argc, char *argv[])
+{
+	const char *eeprom_file = NULL;
+	const char *script_file = NULL;
+	const char *uart_file   = NULL;
+	bool        write_back  = false;
+	bool        dump_lcd    = false;
+	bool        stats       = true;
+	uint64_t    run_ns      = 10000ull * 1000000ull;
+	uint64_t    boot_ns;
+	int         opt;
+
+	while ((opt = getopt(argc, argv, "e:ws:t:u:lqh")) != -1)
+	{
+		switch (opt)
+		{
+			case 'e': eeprom_file = optarg;                               break;
+			case 'w': write_back  = true;                                 break;
+			case 's': script_file = optarg;                               break;
+			case 't': run_ns      = strtoull(optarg, NULL, 10) * 1000000ull; break;
+			case 'u': uart_file   = optarg;                               break;
+			case 'l': dump_lcd    = true;                                 break;
+			case 'q': stats       = false;                                break;
+			default:
+				usage(argv[0]);
+				return 1;
+		}
+	}
+
+	SIM_init();
+
+	if (eeprom_file == NULL || !SIM_eeprom_load(eeprom_file))
+	{
+		if (eeprom_file != NULL && !write_back)
+		{
+			fprintf(stderr, "sim: unable to read %s\n", eeprom_file);
+			return 1;
+		}
+		blank_eeprom();
+	}
+
+	if (script_file != NULL && !SIM_load_script(script_file))
+	{
+		fprintf(stderr, "sim: unable to read %s\n", script_file);
+		return 1;
+	}
+
+	SIM_uart_open(uart_file);
+
+	boot();
+
+	boot_ns = g_sim_time_ns;
+
+	#ifdef ENABLE_SLICE_STATS
+		time_slice_10ms.stats  = &g_time_slice_stats[0];
+		time_slice_500ms.stats = &g_time_slice_stats[1];
+	#endif
+
+	SCHEDULER_start(&time_slice_10ms,  10 / 10,  10 / 10,  time_slice_10ms_due);
+	SCHEDULER_start(&time_slice_40ms,  40 / 10,  40 / 10,  APP_time_slice_40ms);
+	// on the 500ms boundaries, as it always has been
+	SCHEDULER_start(&time_slice_500ms, (500 / 10) - (SCHEDULER_ticks() % (500 / 10)), 500 / 10, time_slice_500ms_due);
+
+	while (g_sim_time_ns < run_ns && !g_sim_quit)
+	{
+		if (!SCHEDULER_pending())
+			SIM_wait_for_interrupt();
+
+		SCHEDULER_dispatch();
+	}
+
+	#ifdef ENABLE_EEPROM_CACHE
+		if (write_back)
+			SETTINGS_flush();   // anything not yet saved
+	#endif
+	#ifdef ENABLE_EEPROM_QUEUE
+		if (write_back)
+			EEPROM_flush();   // anything still queued
+	#endif
+
+	if (dump_lcd)
+		SIM_lcd_dump(stderr);
+
+	if (stats)
+	{
+		fprintf(stderr, "boot time         %.3f sec\n", (double)boot_ns / 1e9);
+		SIM_print_stats(stderr);
+	}
+
+	if (write_back && eeprom_file != NULL && !SIM_eeprom_save(eeprom_file))
+	{
+		fprintf(stderr, "sim: unable to write %s\n", eeprom_file);
+		return 1;
+	}
+
+	return 0;
+}
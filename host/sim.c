@@ -0,0 +1,309 @@
+/* Copyright 2023 One of Eleven
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/mman.h>
+
+#include "driver/bk4819.h"
+#include "host/sim.h"
+
+// all the DP32G030 peripherals live in here
+#define SIM_PERIPH_BASE   0x40000000ul
+#define SIM_PERIPH_SIZE   0x000C0000ul
+
+enum sim_event_type_e {
+	SIM_EVENT_KEY = 0,
+	SIM_EVENT_PTT,
+	SIM_EVENT_REG,
+	SIM_EVENT_UART,
+	SIM_EVENT_LCD,
+	SIM_EVENT_QUIT
+};
+typedef enum sim_event_type_e sim_event_type_t;
+
+typedef struct {
+	uint64_t         time_ns;
+	sim_event_type_t type;
+	int              arg0;
+	int              arg1;
+	unsigned int     size;
+	uint8_t          data[64];
+} sim_event_t;
+
+void SystickHandler(void);
+
+uint64_t    g_sim_time_ns;
+bool        g_sim_quit;
+key_code_t  g_sim_key = KEY_INVALID;
+bool        g_sim_ptt;
+sim_stats_t g_sim_stats;
+
+static uint64_t     next_tick_ns = SIM_TICK_NS;
+static unsigned int pending_ticks;
+static bool         irq_enabled = true;
+static bool         in_handler;
+
+static sim_event_t *events;
+static unsigned int events_count;
+static unsigned int events_index;
+
+static const struct {
+	const char *name;
+	key_code_t  key;
+} key_names[] = {
+	{"0",     KEY_0},    {"1",    KEY_1},    {"2",     KEY_2},     {"3",    KEY_3},
+	{"4",     KEY_4},    {"5",    KEY_5},    {"6",     KEY_6},     {"7",    KEY_7},
+	{"8",     KEY_8},    {"9",    KEY_9},    {"MENU",  KEY_MENU},  {"UP",   KEY_UP},
+	{"DOWN",  KEY_DOWN}, {"EXIT", KEY_EXIT}, {"STAR",  KEY_STAR},  {"F",    KEY_F},
+	{"SIDE1", KEY_SIDE1},{"SIDE2",KEY_SIDE2}
+};
+
+void SIM_init(void)
+{
+	void *p = mmap((void *)SIM_PERIPH_BASE, SIM_PERIPH_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+	if (p != (void *)SIM_PERIPH_BASE)
+	{
+		fprintf(stderr, "sim: unable to map the peripheral address space\n");
+		exit(1);
+	}
+
+	SIM_bk4819_init();
+}
+
+static bool SIM_parse_event(sim_event_t *ev, char *line)
+{
+	char        *tok;
+	char        *save;
+	unsigned int i;
+
+	tok = strtok_r(line, " \t\r\n", &save);
+	if (tok == NULL || tok[0] == '#')
+		return false;
+
+	ev->time_ns = strtoull(tok, NULL, 10) * 1000000ull;
+
+	tok = strtok_r(NULL, " \t\r\n", &save);
+	if (tok == NULL)
+		return false;
+
+	if (strcasecmp(tok, "key") == 0)
+	{	// <ms> key <name> <down|up>
+		const char *name = strtok_r(NULL, " \t\r\n", &save);
+		const char *dir  = strtok_r(NULL, " \t\r\n", &save);
+		if (name == NULL)
+			return false;
+		ev->type = SIM_EVENT_KEY;
+		ev->arg0 = -1;
+		ev->arg1 = (dir == NULL || strcasecmp(dir, "up") != 0) ? 1 : 0;
+		for (i = 0; i < sizeof(key_names) / sizeof(key_names[0]); i++)
+			if (strcasecmp(name, key_names[i].name) == 0)
+				ev->arg0 = key_names[i].key;
+		return ev->arg0 >= 0;
+	}
+
+	if (strcasecmp(tok, "ptt") == 0)
+	{	// <ms> ptt <down|up>
+		const char *dir = strtok_r(NULL, " \t\r\n", &save);
+		ev->type = SIM_EVENT_PTT;
+		ev->arg0 = (dir == NULL || strcasecmp(dir, "up") != 0) ? 1 : 0;
+		return true;
+	}
+
+	if (strcasecmp(tok, "reg") == 0 || strcasecmp(tok, "rssi") == 0)
+	{	// <ms> reg <hex reg> <hex value>   or   <ms> rssi <value>
+		const bool  rssi = (strcasecmp(tok, "rssi") == 0);
+		const char *a    = strtok_r(NULL, " \t\r\n", &save);
+		const char *b    = rssi ? a : strtok_r(NULL, " \t\r\n", &save);
+		if (a == NULL || b == NULL)
+			return false;
+		ev->type = SIM_EVENT_REG;
+		ev->arg0 = rssi ? 0x67 : (int)strtoul(a, NULL, 16);
+		ev->arg1 = rssi ? (int)strtoul(b, NULL, 0) : (int)strtoul(b, NULL, 16);
+		return ev->arg0 >= 0 && ev->arg0 < 128;
+	}
+
+	if (strcasecmp(tok, "uart") == 0)
+	{	// <ms> uart <hex byte> <hex byte> ...
+		ev->type = SIM_EVENT_UART;
+		ev->size = 0;
+		while ((tok = strtok_r(NULL, " \t\r\n", &save)) != NULL && ev->size < sizeof(ev->data))
+			ev->data[ev->size++] = (uint8_t)strtoul(tok, NULL, 16);
+		return ev->size > 0;
+	}
+
+	if (strcasecmp(tok, "lcd") == 0)
+	{	// <ms> lcd
+		ev->type = SIM_EVENT_LCD;
+		return true;
+	}
+
+	if (strcasecmp(tok, "quit") == 0)
+	{	// <ms> quit
+		ev->type = SIM_EVENT_QUIT;
+		return true;
+	}
+
+	return false;
+}
+
+bool SIM_load_script(const char *filename)
+{
+	char         line[512];
+	unsigned int line_num = 0;
+	FILE        *fp       = fopen(filename, "r");
+
+	if (fp == NULL)
+		return false;
+
+	while (fgets(line, sizeof(line), fp) != NULL)
+	{
+		sim_event_t ev;
+		char       *p = line;
+
+		line_num++;
+
+		while (isspace((unsigned char)*p))
+			p++;
+		if (*p == 0 || *p == '#')
+			continue;
+
+		memset(&ev, 0, sizeof(ev));
+		if (!SIM_parse_event(&ev, p))
+		{
+			fprintf(stderr, "sim: %s:%u: bad event\n", filename, line_num);
+			continue;
+		}
+
+		if (events_count > 0 && ev.time_ns < events[events_count - 1].time_ns)
+		{
+			fprintf(stderr, "sim: %s:%u: events must be in time order\n", filename, line_num);
+			continue;
+		}
+
+		events = realloc(events, sizeof(*events) * (events_count + 1));
+		if (events == NULL)
+			break;
+		events[events_count++] = ev;
+	}
+
+	fclose(fp);
+	return true;
+}
+
+static void SIM_process_events(void)
+{
+	while (events_index < events_count && events[events_index].time_ns <= g_sim_time_ns)
+	{
+		const sim_event_t *ev = &events[events_index++];
+
+		switch (ev->type)
+		{
+			case SIM_EVENT_KEY:
+				if (ev->arg1)
+					g_sim_key = (key_code_t)ev->arg0;
+				else
+				if (g_sim_key == (key_code_t)ev->arg0)
+					g_sim_key = KEY_INVALID;
+				break;
+
+			case SIM_EVENT_PTT:
+				g_sim_ptt = ev->arg0 ? true : false;
+				break;
+
+			case SIM_EVENT_REG:
+				SIM_bk4819_set_reg(ev->arg0, ev->arg1);
+				break;
+
+			case SIM_EVENT_UART:
+				SIM_uart_inject(ev->data, ev->size);
+				break;
+
+			case SIM_EVENT_LCD:
+				fprintf(stderr, "sim: lcd @ %llums\n", (unsigned long long)(g_sim_time_ns / 1000000u));
+				SIM_lcd_dump(stderr);
+				break;
+
+			case SIM_EVENT_QUIT:
+				g_sim_quit = true;
+				break;
+		}
+	}
+}
+
+static void SIM_deliver_ticks(void)
+{
+	while (pending_ticks > 0 && irq_enabled && !in_handler)
+	{
+		pending_ticks--;
+		g_sim_stats.ticks++;
+
+		in_handler = true;
+		SystickHandler();
+		in_handler = false;
+	}
+}
+
+void SIM_advance_ns(const uint32_t ns)
+{
+	g_sim_time_ns += ns;
+
+	while (g_sim_time_ns >= next_tick_ns)
+	{
+		next_tick_ns += SIM_TICK_NS;
+		pending_ticks++;
+	}
+
+	SIM_process_events();
+	SIM_deliver_ticks();
+}
+
+void SIM_wait_for_interrupt(void)
+{	// same as the CPU's WFI, jump straight to the next systick
+	if (pending_ticks == 0)
+		SIM_advance_ns((uint32_t)(next_tick_ns - g_sim_time_ns));
+	SIM_deliver_ticks();
+}
+
+void SIM_irq_enable(const bool enable)
+{
+	irq_enabled = enable;
+	if (enable)
+		SIM_deliver_ticks();
+}
+
+void SIM_print_stats(FILE *fp)
+{
+	const double secs = (double)g_sim_time_ns / 1e9;
+
+	fprintf(fp, "sim time          %.3f sec\n", secs);
+	fprintf(fp, "systicks          %u\n", g_sim_stats.ticks);
+	fprintf(fp, "10ms slices       %u\n", g_sim_stats.time_slices_10ms);
+	fprintf(fp, "500ms slices      %u\n", g_sim_stats.time_slices_500ms);
+	fprintf(fp, "bk4819 writes     %u\n", g_sim_stats.bk4819_reg_writes);
+	fprintf(fp, "bk4819 reads      %u\n", g_sim_stats.bk4819_reg_reads);
+	#ifdef ENABLE_BK4819_REG_CACHE
+		fprintf(fp, "bk4819 cache      %u hits, %u misses\n", g_bk4819_reg_cache_hits, g_bk4819_reg_cache_misses);
+	#endif
+	fprintf(fp, "eeprom read       %u bytes\n", g_sim_stats.eeprom_bytes_read);
+	fprintf(fp, "eeprom written    %u bytes in %u write cycles\n", g_sim_stats.eeprom_bytes_written, g_sim_stats.eeprom_write_cycles);
+	fprintf(fp, "eeprom naks       %u\n", g_sim_stats.eeprom_naks);
+	fprintf(fp, "lcd blits         %u full, %u status, %u bytes\n", g_sim_stats.lcd_full_blits, g_sim_stats.lcd_status_blits, g_sim_stats.lcd_bytes);
+}
@@ -0,0 +1,92 @@
+/* Copyright 2023 One of Eleven
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef HOST_SIM_H
+#define HOST_SIM_H
+
+// host (x86-64 linux) simulation of the radio hardware
+//
+// the peripheral address space is backed by plain memory so the firmware's
+// register accesses just work, the buses that matter (BK4819 3-wire, EEPROM
+// I2C) are decoded from the GPIO pin activity, and time only moves forward
+// via the firmwares own delays and bus traffic
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "driver/keyboard.h"
+
+#define SIM_TICK_NS            10000000ull   // 10ms systick
+
+#define SIM_EEPROM_SIZE        0x2000u       // BL24C64
+#define SIM_EEPROM_PAGE_SIZE   32u
+#define SIM_EEPROM_WRITE_NS    5000000ull    // max write cycle time (tWR)
+
+#define SIM_LCD_BYTE_NS        2700u         // approx time to clock one byte out to the ST7565
+
+typedef struct {
+	uint32_t bk4819_reg_writes;
+	uint32_t bk4819_reg_reads;
+	uint32_t eeprom_bytes_read;
+	uint32_t eeprom_bytes_written;
+	uint32_t eeprom_write_cycles;
+	uint32_t eeprom_naks;
+	uint32_t lcd_bytes;
+	uint32_t lcd_full_blits;
+	uint32_t lcd_status_blits;
+	uint32_t ticks;
+	uint32_t time_slices_10ms;
+	uint32_t time_slices_500ms;
+} sim_stats_t;
+
+extern uint64_t    g_sim_time_ns;
+extern bool        g_sim_quit;
+extern key_code_t  g_sim_key;
+extern bool        g_sim_ptt;
+extern sim_stats_t g_sim_stats;
+
+extern uint16_t    g_sim_bk4819_regs[128];
+extern uint8_t     g_sim_eeprom[SIM_EEPROM_SIZE];
+
+// sim.c
+void SIM_init(void);
+bool SIM_load_script(const char *filename);
+void SIM_advance_ns(const uint32_t ns);
+void SIM_wait_for_interrupt(void);
+void SIM_irq_enable(const bool enable);
+void SIM_print_stats(FILE *fp);
+
+// sim_bk4819.c
+void SIM_bk4819_init(void);
+void SIM_bk4819_pins(const uint32_t gpioc);
+int  SIM_bk4819_sda(void);
+void SIM_bk4819_set_reg(const uint8_t reg, const uint16_t value);
+
+// sim_eeprom.c
+bool SIM_eeprom_load(const char *filename);
+bool SIM_eeprom_save(const char *filename);
+void SIM_eeprom_pins(const uint32_t gpioa);
+int  SIM_eeprom_sda(void);
+
+// st7565.c
+void SIM_lcd_dump(FILE *fp);
+
+// uart.c
+void SIM_uart_open(const char *filename);
+void SIM_uart_inject(const uint8_t *data, const unsigned int size);
+
+#endif
@@ -0,0 +1,121 @@
+/* Copyright 2023 One of Eleven
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <string.h>
+
+#include "driver/gpio.h"
+#include "host/sim.h"
+
+// BK4819 register file, driven from the bit-banged 3-wire bus on GPIOC
+//
+// frame = SCN low, 8-bit address (bit-7 set = read), 16-bit data, SCN high
+// data is clocked in/out on the rising edge of SCL, MSB first
+
+uint16_t g_sim_bk4819_regs[128];
+
+static bool     scn = true;
+static bool     scl = true;
+static unsigned bit_count;
+static uint32_t shift;
+static uint8_t  reg;
+static bool     reading;
+
+static bool SIM_bk4819_status_reg(const uint8_t r)
+{	// registers the chip itself drives, the firmware can't write these
+	switch (r)
+	{
+		case 0x0B:
+		case 0x0C:
+		case 0x0D:
+		case 0x0E:
+		case 0x63:
+		case 0x64:
+		case 0x65:
+		case 0x67:
+		case 0x68:
+		case 0x69:
+		case 0x6A:
+		case 0x6F:
+			return true;
+	}
+	return false;
+}
+
+void SIM_bk4819_init(void)
+{
+	memset(g_sim_bk4819_regs, 0, sizeof(g_sim_bk4819_regs));
+
+	g_sim_bk4819_regs[0x67] = 100;  // a little bit of noise floor RSSI
+	g_sim_bk4819_regs[0x65] = 50;   // noise
+}
+
+void SIM_bk4819_set_reg(const uint8_t r, const uint16_t value)
+{
+	g_sim_bk4819_regs[r & 0x7f] = value;
+}
+
+void SIM_bk4819_pins(const uint32_t gpioc)
+{
+	const bool new_scn = (gpioc >> GPIOC_PIN_BK4819_SCN) & 1u;
+	const bool new_scl = (gpioc >> GPIOC_PIN_BK4819_SCL) & 1u;
+	const bool sda     = (gpioc >> GPIOC_PIN_BK4819_SDA) & 1u;
+
+	if (scn && !new_scn)
+	{	// start of frame
+		bit_count = 0;
+		shift     = 0;
+		reading   = false;
+	}
+	else
+	if (!scn && new_scn)
+	{	// end of frame
+		if (bit_count == 24 && !reading)
+		{
+			g_sim_stats.bk4819_reg_writes++;
+
+			if (!SIM_bk4819_status_reg(reg))
+				g_sim_bk4819_regs[reg] = shift & 0xffff;
+
+			if (reg == 0x02)
+				g_sim_bk4819_regs[0x0C] &= ~1u;   // interrupts cleared
+		}
+	}
+	else
+	if (!new_scn && !scl && new_scl && bit_count < 24)
+	{	// rising clock edge
+		if (bit_count < 8 || !reading)
+			shift = (shift << 1) | (sda ? 1u : 0u);
+
+		if (++bit_count == 8)
+		{
+			reg     = shift & 0x7f;
+			reading = (shift & 0x80) ? true : false;
+			shift   = 0;
+			if (reading)
+				g_sim_stats.bk4819_reg_reads++;
+		}
+	}
+
+	scn = new_scn;
+	scl = new_scl;
+}
+
+int SIM_bk4819_sda(void)
+{	// the chip only drives SDA when it's sending register data back
+	if (scn || !reading || bit_count < 8 || bit_count >= 24)
+		return -1;
+	return (g_sim_bk4819_regs[reg] >> (15 - (bit_count - 8))) & 1u;
+}
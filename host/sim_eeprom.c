@@ -0,0 +1,236 @@
+/* Copyright 2023 One of Eleven
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <string.h>
+
+#include "driver/gpio.h"
+#include "host/sim.h"
+
+// BL24C64 8kB I2C EEPROM, driven from the bit-banged I2C bus on GPIOA
+//
+// 32 byte pages, the internal address wraps inside the page on writes,
+// and the chip ignores (NAK's) everything while it's burning a page
+
+#define SIM_EEPROM_ADDR_WRITE   0xA0
+#define SIM_EEPROM_ADDR_READ    0xA1
+
+enum eeprom_state_e {
+	EEPROM_STATE_IDLE = 0,      // waiting for a START
+	EEPROM_STATE_DEVICE,        // receiving the device address
+	EEPROM_STATE_ADDR_HI,       // receiving the memory address
+	EEPROM_STATE_ADDR_LO,
+	EEPROM_STATE_WRITE,         // receiving data
+	EEPROM_STATE_READ,          // sending data
+	EEPROM_STATE_IGNORE         // not for us
+};
+typedef enum eeprom_state_e eeprom_state_t;
+
+uint8_t g_sim_eeprom[SIM_EEPROM_SIZE];
+
+static bool           scl = true;
+static bool           sda = true;
+static eeprom_state_t state;
+static unsigned int   bit_count;
+static uint8_t        shift;
+static bool           ack;
+static bool           read_data;    // past the device address ACK of a read
+static uint16_t       address;
+static uint8_t        page[SIM_EEPROM_PAGE_SIZE];
+static uint32_t       page_mask;
+static uint16_t       page_address;
+static uint64_t       busy_until_ns;
+
+bool SIM_eeprom_load(const char *filename)
+{
+	FILE *fp;
+
+	memset(g_sim_eeprom, 0xff, sizeof(g_sim_eeprom));
+
+	if (filename == NULL)
+		return true;
+
+	fp = fopen(filename, "rb");
+	if (fp == NULL)
+		return false;
+	if (fread(g_sim_eeprom, 1, sizeof(g_sim_eeprom), fp) == 0)
+		fprintf(stderr, "sim: %s is empty\n", filename);
+	fclose(fp);
+
+	return true;
+}
+
+bool SIM_eeprom_save(const char *filename)
+{
+	FILE  *fp = fopen(filename, "wb");
+	size_t written;
+
+	if (fp == NULL)
+		return false;
+	written = fwrite(g_sim_eeprom, 1, sizeof(g_sim_eeprom), fp);
+	fclose(fp);
+
+	return written == sizeof(g_sim_eeprom);
+}
+
+static void SIM_eeprom_commit(void)
+{	// STOP after a write .. burn the page
+	unsigned int i;
+
+	if (page_mask == 0)
+		return;
+
+	for (i = 0; i < SIM_EEPROM_PAGE_SIZE; i++)
+	{
+		if (page_mask & (1u << i))
+		{
+			g_sim_eeprom[page_address + i] = page[i];
+			g_sim_stats.eeprom_bytes_written++;
+		}
+	}
+
+	g_sim_stats.eeprom_write_cycles++;
+
+	busy_until_ns = g_sim_time_ns + SIM_EEPROM_WRITE_NS;
+	page_mask     = 0;
+}
+
+static void SIM_eeprom_byte(const uint8_t data)
+{	// a full byte has been clocked in from the master
+	ack = true;
+
+	switch (state)
+	{
+		case EEPROM_STATE_DEVICE:
+			if ((data & 0xfe) != SIM_EEPROM_ADDR_WRITE)
+			{
+				state = EEPROM_STATE_IGNORE;
+				ack   = false;
+				break;
+			}
+			if (g_sim_time_ns < busy_until_ns)
+			{	// still burning the last page
+				state = EEPROM_STATE_IGNORE;
+				ack   = false;
+				g_sim_stats.eeprom_naks++;
+				break;
+			}
+			state     = (data == SIM_EEPROM_ADDR_READ) ? EEPROM_STATE_READ : EEPROM_STATE_ADDR_HI;
+			read_data = false;
+			break;
+
+		case EEPROM_STATE_ADDR_HI:
+			address = (uint16_t)(data << 8) & (SIM_EEPROM_SIZE - 1);
+			state   = EEPROM_STATE_ADDR_LO;
+			break;
+
+		case EEPROM_STATE_ADDR_LO:
+			address      |= data;
+			page_address  = address & ~(SIM_EEPROM_PAGE_SIZE - 1);
+			page_mask     = 0;
+			state         = EEPROM_STATE_WRITE;
+			break;
+
+		case EEPROM_STATE_WRITE:
+			{
+				const unsigned int offset = address & (SIM_EEPROM_PAGE_SIZE - 1);
+				page[offset] = data;
+				page_mask   |= 1u << offset;
+				address      = page_address | ((offset + 1) & (SIM_EEPROM_PAGE_SIZE - 1));
+			}
+			break;
+
+		default:
+			ack = false;
+			break;
+	}
+}
+
+void SIM_eeprom_pins(const uint32_t gpioa)
+{
+	const bool new_scl = (gpioa >> GPIOA_PIN_I2C_SCL) & 1u;
+	const bool new_sda = (gpioa >> GPIOA_PIN_I2C_SDA) & 1u;
+
+	if (scl && new_scl && sda != new_sda)
+	{	// SDA changed while SCL high .. START or STOP
+		if (!new_sda)
+		{	// START (or repeated START)
+			if (state == EEPROM_STATE_WRITE)
+				page_mask = 0;   // repeated START aborts the write
+			state     = EEPROM_STATE_DEVICE;
+			bit_count = 0;
+			shift     = 0;
+			ack       = false;
+		}
+		else
+		{	// STOP
+			if (state == EEPROM_STATE_WRITE)
+				SIM_eeprom_commit();
+			state = EEPROM_STATE_IDLE;
+			ack   = false;
+		}
+	}
+	else
+	if (!scl && new_scl && state != EEPROM_STATE_IDLE)
+	{	// rising clock edge
+		if (bit_count < 8)
+		{
+			shift = (uint8_t)((shift << 1) | (new_sda ? 1u : 0u));
+			if (++bit_count == 8 && state != EEPROM_STATE_READ)
+				SIM_eeprom_byte(shift);
+		}
+		else
+		{	// 9th clock .. the ACK bit
+			bit_count++;
+			if (state == EEPROM_STATE_READ && !read_data)
+			{	// that was us ACK'ing the device address
+				read_data = true;
+			}
+			else
+			if (state == EEPROM_STATE_READ)
+			{
+				address = (address + 1) & (SIM_EEPROM_SIZE - 1);
+				g_sim_stats.eeprom_bytes_read++;
+				if (new_sda)
+					state = EEPROM_STATE_IGNORE;   // master NAK'ed .. end of read
+			}
+		}
+	}
+	else
+	if (scl && !new_scl && bit_count >= 9)
+	{	// falling clock edge after the ACK bit
+		bit_count = 0;
+		shift     = 0;
+		ack       = false;
+	}
+
+	scl = new_scl;
+	sda = new_sda;
+}
+
+int SIM_eeprom_sda(void)
+{
+	if (ack)
+		return 0;
+
+	if (state == EEPROM_STATE_READ)
+	{	// the master samples while SCL is high, by which time the clock edge has been counted
+		const unsigned int index = scl ? bit_count - 1 : bit_count;
+		if (index < 8)
+			return (g_sim_eeprom[address] >> (7 - index)) & 1u;
+	}
+
+	return -1;
+}
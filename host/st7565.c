@@ -0,0 +1,261 @@
+/* Copyright 2023 One of Eleven
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#include <string.h>
+
+#include "driver/st7565.h"
+#include "driver/system.h"
+#include "host/sim.h"
+#include "misc.h"
+
+// ST7565 frame sink, keeps a copy of what the LCD's own display RAM would hold
+
+uint8_t g_status_line[128];
+uint8_t g_frame_buffer[7][128];
+
+#ifdef ENABLE_CONTRAST
+	uint8_t contrast = 31;  // 0 ~ 63
+#endif
+
+static uint8_t lcd_ram[8][132];
+
+#ifdef ENABLE_LCD_PARTIAL_BLIT
+	#define ST7565_REDRAW_500ms   (4000 / 500)
+
+	static uint8_t      lcd_ram_valid;        // a bit per line, the same as the firmware's copy of what it's sent
+	static unsigned int lcd_redraw_count;
+#endif
+
+#ifdef ENABLE_LCD_ASYNC_BLIT
+	static uint64_t lcd_busy_until_ns;    // when the firmware's main loop will have fed out everything queued
+#endif
+
+static void ST7565_Bytes(const unsigned int count)
+{
+	g_sim_stats.lcd_bytes += count;
+	SIM_advance_ns(count * SIM_LCD_BYTE_NS);
+}
+
+#ifdef ENABLE_LCD_ASYNC_BLIT
+	static void ST7565_QueueBytes(const unsigned int count)
+	{	// sent in the background, the blit doesn't wait for them
+		g_sim_stats.lcd_bytes += count;
+
+		if (lcd_busy_until_ns < g_sim_time_ns)
+		{	// starting afresh, the start line command goes first
+			lcd_busy_until_ns = g_sim_time_ns + SIM_LCD_BYTE_NS;
+			g_sim_stats.lcd_bytes++;
+		}
+
+		lcd_busy_until_ns += (uint64_t)count * SIM_LCD_BYTE_NS;
+	}
+
+	void ST7565_Process(void)
+	{
+	}
+
+	bool ST7565_Pending(void)
+	{
+		return false;
+	}
+
+	void ST7565_Flush(void)
+	{
+		if (lcd_busy_until_ns > g_sim_time_ns)
+			SIM_advance_ns((uint32_t)(lcd_busy_until_ns - g_sim_time_ns));
+	}
+#endif
+
+void SIM_lcd_dump(FILE *fp)
+{
+	unsigned int y;
+
+	for (y = 0; y < LCD_HEIGHT; y++)
+	{
+		unsigned int x;
+		char         line[LCD_WIDTH + 2];
+
+		for (x = 0; x < LCD_WIDTH; x++)
+			line[x] = ((lcd_ram[y / 8][x + 4] >> (y & 7u)) & 1u) ? '#' : '.';
+		line[x++] = '\n';
+		line[x]   = 0;
+
+		fputs(line, fp);
+	}
+}
+
+void ST7565_DrawLine(const unsigned int Column, const unsigned int Line, const unsigned int Size, const uint8_t *pBitmap)
+{
+	unsigned int i;
+
+	#ifdef ENABLE_LCD_ASYNC_BLIT
+		ST7565_Flush();
+	#endif
+
+	ST7565_Bytes(3 + Size);
+
+	for (i = 0; i < Size && (Column + 4 + i) < ARRAY_SIZE(lcd_ram[0]); i++)
+		lcd_ram[Line & 7u][Column + 4 + i] = (pBitmap != NULL) ? pBitmap[i] : 0;
+}
+
+#ifdef ENABLE_LCD_PARTIAL_BLIT
+	static void ST7565_BlitLine(const unsigned int Line, const uint8_t *pLine)
+	{	// same spans as the firmware sends
+		uint8_t     *shown  = &lcd_ram[Line][4];
+		const bool   valid  = (lcd_ram_valid & (1u << Line)) ? true : false;
+		unsigned int Column = 0;
+
+		while (Column < LCD_WIDTH)
+		{
+			unsigned int end;
+			unsigned int i;
+
+			if (valid && pLine[Column] == shown[Column])
+			{
+				Column++;
+				continue;
+			}
+
+			for (i = end = Column + 1; i < LCD_WIDTH && i < (end + 3); i++)
+				if (!valid || pLine[i] != shown[i])
+					end = i + 1;
+
+			#ifdef ENABLE_LCD_ASYNC_BLIT
+				ST7565_QueueBytes(3 + (end - Column));
+			#else
+				ST7565_Bytes(3 + (end - Column));
+			#endif
+			memcpy(&shown[Column], &pLine[Column], end - Column);
+
+			Column = end;
+		}
+
+		lcd_ram_valid |= 1u << Line;
+	}
+
+	void ST7565_Refresh(void)
+	{
+		ST7565_Init(false);
+
+		if (++lcd_redraw_count >= ST7565_REDRAW_500ms)
+		{
+			lcd_redraw_count = 0;
+			lcd_ram_valid    = 0;
+		}
+	}
+#endif
+
+void ST7565_BlitFullScreen(void)
+{
+	unsigned int Line;
+
+	#ifndef ENABLE_LCD_PARTIAL_BLIT
+		ST7565_Init(false);
+	#endif
+
+	#ifndef ENABLE_LCD_ASYNC_BLIT
+		ST7565_Bytes(1);
+	#endif
+
+	for (Line = 0; Line < ARRAY_SIZE(g_frame_buffer); Line++)
+	{
+		#ifdef ENABLE_LCD_PARTIAL_BLIT
+			ST7565_BlitLine(Line + 1, g_frame_buffer[Line]);
+		#else
+			ST7565_Bytes(3 + ARRAY_SIZE(g_frame_buffer[0]));
+			memcpy(&lcd_ram[Line + 1][4], g_frame_buffer[Line], sizeof(g_frame_buffer[0]));
+		#endif
+	}
+
+	g_sim_stats.lcd_full_blits++;
+}
+
+void ST7565_BlitStatusLine(void)
+{
+	#ifdef ENABLE_LCD_PARTIAL_BLIT
+		#ifndef ENABLE_LCD_ASYNC_BLIT
+			ST7565_Bytes(1);
+		#endif
+		ST7565_BlitLine(0, g_status_line);
+	#else
+		ST7565_Bytes(4 + ARRAY_SIZE(g_status_line));
+		memcpy(&lcd_ram[0][4], g_status_line, sizeof(g_status_line));
+	#endif
+
+	g_sim_stats.lcd_status_blits++;
+}
+
+void ST7565_FillScreen(const uint8_t Value)
+{
+	ST7565_Init(false);
+
+	ST7565_Bytes(8 * (3 + ARRAY_SIZE(lcd_ram[0])));
+	memset(lcd_ram, Value, sizeof(lcd_ram));
+	#ifdef ENABLE_LCD_PARTIAL_BLIT
+		lcd_ram_valid = (1u << ARRAY_SIZE(lcd_ram)) - 1;
+	#endif
+}
+
+void ST7565_Init(const bool full)
+{
+	if (full)
+	{
+		ST7565_HardwareReset();
+		SYSTEM_DelayMs(120);
+	}
+	#ifdef ENABLE_LCD_ASYNC_BLIT
+		else
+			ST7565_Flush();
+	#endif
+
+	ST7565_Bytes(9);
+
+	if (full)
+	{
+		SYSTEM_DelayMs(50 + 50 + 10);
+		ST7565_Bytes(4);
+	}
+
+	ST7565_Bytes(2);
+
+	if (full)
+		ST7565_FillScreen(0x00);
+}
+
+void ST7565_HardwareReset(void)
+{
+	SYSTEM_DelayMs(1 + 20 + 120);
+}
+
+void ST7565_SelectColumnAndLine(const uint8_t Column, const uint8_t Line)
+{
+	(void)Column;
+	(void)Line;
+	ST7565_Bytes(3);
+}
+
+#ifdef ENABLE_CONTRAST
+	void ST7565_SetContrast(const uint8_t value)
+	{
+		contrast = (value > 45) ? 45 : (value < 26) ? 26 : value;
+	}
+
+	uint8_t ST7565_GetContrast(void)
+	{
+		return contrast;
+	}
+#endif
@@ -0,0 +1,33 @@
+/* Copyright 2023 One of Eleven
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#include "driver/systick.h"
+#include "host/sim.h"
+
+void SYSTICK_Init(void)
+{
+}
+
+void SYSTICK_Delay250ns(const uint32_t Delay)
+{
+	SIM_advance_ns(Delay * 250u);
+}
+
+uint32_t SYSTICK_get_us(void)
+{
+	return (uint32_t)(g_sim_time_ns / 1000u);
+}
@@ -0,0 +1,135 @@
+/* Copyright 2023 One of Eleven
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <stdarg.h>
+#include <string.h>
+
+#include "bsp/dp32g030/dma.h"
+#include "driver/uart.h"
+#include "external/printf/printf.h"
+#include "host/sim.h"
+
+// the UART1 RX DMA ring is filled by the simulator, TX goes to a file (stdout by default)
+
+#define UART_BYTE_NS   260417u   // 38400 baud, 10 bits per byte
+#define UART_FIFO_SIZE 8
+
+uint8_t         UART_DMA_Buffer[256];
+static FILE    *uart_out;
+static uint64_t uart_fifo_empty_ns;    // when the bytes in the TX FIFO will have gone
+
+void SIM_uart_open(const char *filename)
+{
+	uart_out = (filename != NULL) ? fopen(filename, "wb") : NULL;
+	if (filename != NULL && uart_out == NULL)
+		fprintf(stderr, "sim: unable to create %s\n", filename);
+}
+
+void SIM_uart_inject(const uint8_t *data, const unsigned int size)
+{	// the DMA channel writing the RX bytes into the ring buffer
+	unsigned int i;
+	uint32_t     index = DMA_CH0->ST & 0xFFFu;
+
+	for (i = 0; i < size; i++)
+	{
+		UART_DMA_Buffer[index] = data[i];
+		index = (index + 1) % sizeof(UART_DMA_Buffer);
+	}
+
+	DMA_CH0->ST = (DMA_CH0->ST & ~0xFFFu) | index;
+}
+
+void UART_Init(void)
+{
+	DMA_CH0->ST = 0;
+	if (uart_out == NULL)
+		uart_out = stdout;
+}
+
+static void uart_write(const void *pBuffer, uint32_t Size)
+{
+	if (uart_out != NULL)
+	{
+		fwrite(pBuffer, 1, Size, uart_out);
+		fflush(uart_out);
+	}
+}
+
+void UART_Send(const void *pBuffer, uint32_t Size)
+{	// waits for whatever's still in the FIFO, then for its own bytes
+	if (uart_fifo_empty_ns > g_sim_time_ns)
+		SIM_advance_ns((uint32_t)(uart_fifo_empty_ns - g_sim_time_ns));
+
+	SIM_advance_ns(Size * UART_BYTE_NS);
+
+	uart_write(pBuffer, Size);
+}
+
+uint32_t UART_SendSome(const void *pBuffer, uint32_t Size)
+{	// as much as fits in the FIFO, which empties a byte every UART_BYTE_NS
+	uint32_t queued = 0;
+	uint32_t room;
+
+	if (uart_fifo_empty_ns > g_sim_time_ns)
+		queued = (uint32_t)((uart_fifo_empty_ns - g_sim_time_ns + UART_BYTE_NS - 1) / UART_BYTE_NS);
+	else
+		uart_fifo_empty_ns = g_sim_time_ns;
+
+	room = (queued < UART_FIFO_SIZE) ? UART_FIFO_SIZE - queued : 0;
+	if (Size > room)
+		Size = room;
+
+	uart_fifo_empty_ns += (uint64_t)Size * UART_BYTE_NS;
+
+	uart_write(pBuffer, Size);
+
+	return Size;
+}
+
+void UART_SendText(const void *str)
+{
+	if (str)
+		UART_Send(str, strlen(str));
+}
+
+void UART_LogSend(const void *pBuffer, uint32_t Size)
+{
+	(void)pBuffer;
+	(void)Size;
+}
+
+void UART_LogSendText(const void *str)
+{
+	(void)str;
+}
+
+void _putchar(char c)
+{	// only referenced by the (unused on the radio) printf_() .. the arm LTO drops it
+	UART_Send(&c, 1);
+}
+
+void UART_printf(const char *str, ...)
+{
+	char text[256];
+	int  len;
+
+	va_list va;
+	va_start(va, str);
+		len = vsnprintf(text, sizeof(text), str, va);
+	va_end(va);
+
+	UART_Send(text, len);
+}
@@ -45,6 +45,7 @@
 #endif
 #include "misc.h"
 #include "radio.h"
+#include "scheduler.h"
 #include "settings.h"
 #include "ui/helper.h"
 #include "ui/lock.h"
@@ -62,6 +63,9 @@ void MAIN_DisplayReleaseKeys(void)
 
 	ST7565_BlitStatusLine();  // blank status line
 	ST7565_BlitFullScreen();
+	#ifdef ENABLE_LCD_ASYNC_BLIT
+		ST7565_Flush();       // the main loop isn't running yet to send it
+	#endif
 
 	BACKLIGHT_turn_on(0);
 }
@@ -143,6 +147,9 @@ void MAIN_DisplayPowerOn(void)
 	{
 		ST7565_BlitStatusLine();
 		ST7565_BlitFullScreen();
+		#ifdef ENABLE_LCD_ASYNC_BLIT
+			ST7565_Flush();   // the main loop isn't running yet to send it
+		#endif
 	}
 
 	if (g_eeprom.config.setting.power_on_display_mode != PWR_ON_DISPLAY_MODE_NONE)
@@ -151,8 +158,11 @@ void MAIN_DisplayPowerOn(void)
 
 void Main(void)
 {
-	unsigned int i;
-	boot_mode_t  BootMode;
+	static sched_timer_t time_slice_10ms;
+	static sched_timer_t time_slice_40ms;
+	static sched_timer_t time_slice_500ms;
+	unsigned int         i;
+	boot_mode_t          BootMode;
 
 	// Enable clock gating of blocks we need
 	SYSCON_DEV_CLK_GATE = 0
@@ -168,6 +178,8 @@ void Main(void)
 
 	SYSTICK_Init();
 
+	SCHEDULER_start(&g_boot_timer, boot_10ms, 0, NULL);   // the boot screen/beeps
+
 	BOARD_PORTCON_Init();
 	BOARD_GPIO_Init();
 	CRC_Init();
@@ -247,6 +259,10 @@ void Main(void)
 	RADIO_select_vfos();
 	RADIO_setup_registers(true);
 
+	#ifdef ENABLE_SLICE_STATS
+		g_boot_rx_us = SYSTICK_get_us();
+	#endif
+
 	for (i = 0; i < ARRAY_SIZE(g_battery_voltages); i++)
 		BOARD_ADC_GetBatteryInfo(&g_battery_voltages[i], &g_usb_current);
 	BATTERY_GetReadings(false);
@@ -295,17 +311,20 @@ void Main(void)
 
 		if (g_eeprom.config.setting.power_on_display_mode != PWR_ON_DISPLAY_MODE_NONE)
 		{	// 3 second boot-up screen
-			while (g_boot_tick_10ms > 0)
+			while (SCHEDULER_remaining(&g_boot_timer) > 0)
 			{
-				if (KEYBOARD_Poll() != KEY_INVALID)
-				{	// halt boot beeps and cancel boot screen
-					g_boot_tick_10ms = 0;
+				if (KEYBOARD_Poll() != KEY_INVALID || !GPIO_CheckBit(&GPIOC->DATA, GPIOC_PIN_PTT))
+				{	// halt boot beeps and cancel boot screen, the receiver's already set up
+					SCHEDULER_stop(&g_boot_timer);
 					break;
 				}
 				#ifdef ENABLE_BOOT_BEEPS
-					if ((g_boot_tick_10ms % 25) == 0)
+					if ((SCHEDULER_remaining(&g_boot_timer) % 25) == 0)
 						AUDIO_PlayBeep(BEEP_880HZ_40MS_OPTIONAL);
 				#endif
+				#ifdef ENABLE_EEPROM_LAZY_LOAD
+					SETTINGS_load_next();   // might as well while we're waiting
+				#endif
 			}
 		}
 
@@ -348,6 +367,16 @@ void Main(void)
 		#endif
 	}
 
+	#ifdef ENABLE_SLICE_STATS
+		time_slice_10ms.stats  = &g_time_slice_stats[0];
+		time_slice_500ms.stats = &g_time_slice_stats[1];
+	#endif
+
+	SCHEDULER_start(&time_slice_10ms,  10 / 10,  10 / 10,  APP_time_slice_10ms);
+	SCHEDULER_start(&time_slice_40ms,  40 / 10,  40 / 10,  APP_time_slice_40ms);
+	// on the 500ms boundaries, as it always has been
+	SCHEDULER_start(&time_slice_500ms, (500 / 10) - (SCHEDULER_ticks() % (500 / 10)), 500 / 10, APP_time_slice_500ms);
+
 	// Everything is initialised, set SLEEP* bits
 	SYSCON_REGISTER |= SYSCON_REGISTER_SLEEPONEXIT_BITS_ENABLE;
 	SYSCON_REGISTER |= SYSCON_REGISTER_SLEEPDEEP_BITS_ENABLE;
@@ -357,24 +386,22 @@ void Main(void)
 		#if 1
 			// Mask interrupts
 			__asm volatile ("cpsid i");
-			if (!g_next_time_slice)
-				// Idle condition, hint the MCU to sleep
+			#ifdef ENABLE_LCD_ASYNC_BLIT
+				if (!SCHEDULER_pending() && !ST7565_Pending())
+			#else
+				if (!SCHEDULER_pending())
+			#endif
+				// Idle condition, hint the MCU to sleep until a timer is due
 				// CMSIS suggests GCC reorders memory and is undesirable
 				__asm volatile ("wfi":::"memory");
 			// Unmask interrupts
 			__asm volatile ("cpsie i");
 		#endif
 
-		if (g_next_time_slice)
-		{
-			APP_time_slice_10ms();
-			g_next_time_slice = false;
-		}
+		#ifdef ENABLE_LCD_ASYNC_BLIT
+			ST7565_Process();   // feed the LCD
+		#endif
 
-		if (g_next_time_slice_500ms)
-		{
-			APP_time_slice_500ms();
-			g_next_time_slice_500ms = false;
-		}
+		SCHEDULER_dispatch();
 	}
 }
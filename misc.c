@@ -60,7 +60,12 @@ const uint8_t         dtmf_rx_timeout_500ms            =  10000 / 500;  // 10 se
 const uint8_t         dtmf_decode_ring_500ms           =  15000 / 500;  // 15 seconds .. time we sound the ringing for
 const uint8_t         dtmf_txstop_500ms                =   3000 / 500;  // 6 seconds
 
-const uint8_t         serial_config_tick_500ms         =   3000 / 500;  // 3 seconds
+const uint16_t        serial_config_10ms               =   3000 / 10;   // 3 seconds
+#ifdef ENABLE_EEPROM_LAZY_LOAD
+	const uint16_t    boot_10ms                        =   1000 / 10;   // 1 second, the rest of the eeprom is read in after the boot screen
+#else
+	const uint16_t    boot_10ms                        =   4000 / 10;   // 4 seconds
+#endif
 
 const uint8_t         key_input_timeout_500ms          =   8000 / 500;  // 8 seconds
 #ifdef ENABLE_KEYLOCK
@@ -91,6 +96,26 @@ const uint16_t        scan_pause_cdcss_10ms            =    300 / 10;   // 300ms
 const uint16_t        scan_pause_freq_10ms             =    100 / 10;   // 100ms
 const uint16_t        scan_pause_chan_10ms             =    200 / 10;   // 200ms
 
+#ifdef ENABLE_FAST_FREQ_SCAN
+	const uint16_t    fast_scan_lock_250ns             =   1000 * 4;    // 1ms for the VCO/PLL to lock
+	const uint16_t    fast_scan_settle_250ns           =    250 * 4;    // 250us between RSSI settle checks
+	const uint8_t     fast_scan_settle_tries           =      6;        // upto 1.5ms more for the RSSI to settle
+	const uint8_t     fast_scan_steps_per_tick         =      3;        // quiet steps looked at per 10ms tick
+	const uint16_t    fast_scan_budget_us              =   6000;        // time we can spend looking at steps per 10ms tick
+	#ifdef ENABLE_SCAN_SETTLE_CAL
+		const uint16_t fast_scan_step_us               =    300;        // bus traffic per step, on top of the settle time
+	#endif
+#endif
+
+#ifdef ENABLE_SCAN_SETTLE_CAL
+	const uint16_t    scan_settle_min_us               =   1000;        // never less than the VCO/PLL lock time, the RSSI can look steady before then
+#endif
+
+#ifdef ENABLE_SPECTRUM
+	const uint16_t    spectrum_settle_us               =    500;        // RSSI settle time after a one point step (if not calibrated)
+	const uint16_t    spectrum_budget_us               =   8000;        // time we can spend sweeping per 10ms tick
+#endif
+
 const uint16_t        power_save_pause_10ms            =  10000 / 10;   // 10 seconds
 const uint16_t        power_save1_10ms                 =    100 / 10;   // 100ms
 const uint16_t        power_save2_10ms                 =    200 / 10;   // 200ms
@@ -124,15 +149,13 @@ volatile uint16_t     g_dual_watch_tick_10ms;
 volatile bool         g_dual_watch_delay_down_expired = true;
 
 #if defined(ENABLE_UART)
-	volatile uint8_t  g_serial_config_tick_500ms;
+	sched_timer_t     g_serial_config_timer;
 #endif
 
-volatile bool         g_next_time_slice_500ms;
-
-volatile uint16_t     g_tx_timer_tick_500ms;
+sched_timer_t         g_tx_timer;
 volatile bool         g_tx_timeout_reached;
 
-volatile uint16_t     g_tail_tone_elimination_tick_10ms;
+sched_timer_t         g_tail_tone_elimination_timer;
 
 #ifdef ENABLE_NOAA
 	volatile uint16_t g_noaa_tick_10ms;
@@ -199,7 +222,7 @@ uint8_t               g_ctcss_tail_phase_shift_rx;
 	bool              g_vox_audio_detected;
 	uint16_t          g_vox_resume_tick_10ms;
 	uint16_t          g_vox_pause_tick_10ms;
-	volatile uint16_t g_vox_stop_tick_10ms;
+	sched_timer_t     g_vox_stop_timer;
 #endif
 
 bool                  g_squelch_open;
@@ -242,15 +265,15 @@ uint8_t               g_backup_cross_vfo;
 
 bool                  g_unhide_hidden;
 
-volatile bool         g_next_time_slice;
-volatile bool         g_next_time_slice_40ms;
-
-volatile uint8_t      g_found_cdcss_tick_10ms;
-volatile uint8_t      g_found_ctcss_tick_10ms;
+sched_timer_t         g_found_ctcss_timer;
 
 volatile bool         g_flag_tail_tone_elimination_complete;
 
-volatile uint16_t     g_boot_tick_10ms = 4000 / 10;   // 4 seconds
+sched_timer_t         g_boot_timer;
+#ifdef ENABLE_SLICE_STATS
+	uint32_t          g_boot_rx_us;                   // power-on to the receiver being set up
+	uint32_t          g_boot_loaded_us;               // power-on to all of the eeprom being in RAM
+#endif
 
 int16_t               g_current_rssi[2];
 uint16_t              g_current_glitch[2];
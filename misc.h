@@ -22,6 +22,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "scheduler.h"
 //#include "settings.h"
 
 #ifndef ARRAY_SIZE
@@ -142,7 +143,8 @@ extern const uint8_t         dtmf_rx_timeout_500ms;
 extern const uint8_t         dtmf_decode_ring_500ms;
 extern const uint8_t         dtmf_txstop_500ms;
 
-extern const uint8_t         serial_config_tick_500ms;
+extern const uint16_t        serial_config_10ms;
+extern const uint16_t        boot_10ms;
 
 extern const uint8_t         key_input_timeout_500ms;
 
@@ -187,6 +189,26 @@ extern const uint16_t        scan_pause_cdcss_10ms;
 extern const uint16_t        scan_pause_freq_10ms;
 extern const uint16_t        scan_pause_chan_10ms;
 
+#ifdef ENABLE_FAST_FREQ_SCAN
+	extern const uint16_t    fast_scan_lock_250ns;
+	extern const uint16_t    fast_scan_settle_250ns;
+	extern const uint8_t     fast_scan_settle_tries;
+	extern const uint8_t     fast_scan_steps_per_tick;
+	extern const uint16_t    fast_scan_budget_us;
+	#ifdef ENABLE_SCAN_SETTLE_CAL
+		extern const uint16_t fast_scan_step_us;
+	#endif
+#endif
+
+#ifdef ENABLE_SCAN_SETTLE_CAL
+	extern const uint16_t    scan_settle_min_us;
+#endif
+
+#ifdef ENABLE_SPECTRUM
+	extern const uint16_t    spectrum_settle_us;
+	extern const uint16_t    spectrum_budget_us;
+#endif
+
 extern const uint8_t         g_mic_gain_dB_2[5];
 
 extern bool                  g_monitor_enabled;
@@ -203,15 +225,13 @@ extern volatile uint16_t     g_dual_watch_tick_10ms;
 extern volatile bool         g_dual_watch_delay_down_expired;
 
 #if defined(ENABLE_UART)
-	extern volatile uint8_t  g_serial_config_tick_500ms;
+	extern sched_timer_t     g_serial_config_timer;   // running while a PC is talking to us
 #endif
 
-extern volatile bool         g_next_time_slice_500ms;
-
-extern volatile uint16_t     g_tx_timer_tick_500ms;
+extern sched_timer_t         g_tx_timer;              // sets 'g_tx_timeout_reached' when the TX time is up
 extern volatile bool         g_tx_timeout_reached;
 
-extern volatile uint16_t     g_tail_tone_elimination_tick_10ms;
+extern sched_timer_t         g_tail_tone_elimination_timer;
 
 #ifdef ENABLE_FMRADIO
 	extern volatile uint16_t g_fm_play_tick_10ms;
@@ -309,18 +329,15 @@ extern uint8_t               g_backup_cross_vfo;
 	extern bool              g_noaa_mode;
 	extern uint8_t           g_noaa_channel;
 #endif
-extern volatile bool         g_next_time_slice;
 extern bool                  g_update_display;
 extern bool                  g_unhide_hidden;
 #ifdef ENABLE_FMRADIO
 	extern uint8_t           g_fm_channel_position;
 #endif
-extern volatile uint8_t      g_found_cdcss_tick_10ms;
-extern volatile uint8_t      g_found_ctcss_tick_10ms;
+extern sched_timer_t         g_found_ctcss_timer;
 #ifdef ENABLE_VOX
-	extern volatile uint16_t g_vox_stop_tick_10ms;
+	extern sched_timer_t     g_vox_stop_timer;
 #endif
-extern volatile bool         g_next_time_slice_40ms;
 #ifdef ENABLE_NOAA
 	extern volatile uint16_t g_noaa_tick_10ms;
 	extern volatile bool     g_schedule_noaa;
@@ -331,7 +348,11 @@ extern int16_t               g_current_rssi[2];
 extern uint16_t              g_current_glitch[2];
 extern uint16_t              g_current_noise[2];
 
-extern volatile uint16_t     g_boot_tick_10ms;
+extern sched_timer_t         g_boot_timer;
+#ifdef ENABLE_SLICE_STATS
+	extern uint32_t          g_boot_rx_us;
+	extern uint32_t          g_boot_loaded_us;
+#endif
 
 extern uint8_t               g_mic_sensitivity_tuning;
 
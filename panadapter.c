@@ -28,35 +28,167 @@ unsigned int  g_panadapter_cycles;       //
 uint8_t       g_panadapter_max_rssi;     //
 uint8_t       g_panadapter_min_rssi;     //
 uint8_t       g_panadapter_rssi[PANADAPTER_BINS + 1 + PANADAPTER_BINS]; // holds the RSSI samples
+#ifdef ENABLE_PANADAPTER_AVG_PEAK
+	uint16_t      g_panadapter_avg_rssi[PANADAPTER_BINS + 1 + PANADAPTER_BINS];
+	uint8_t       g_panadapter_peak_rssi[PANADAPTER_BINS + 1 + PANADAPTER_BINS];
+#endif
+#ifdef ENABLE_PANADAPTER_WATERFALL
+	uint8_t       g_panadapter_waterfall[PANADAPTER_WATERFALL_LINES][((PANADAPTER_BINS + 1 + PANADAPTER_BINS) * PANADAPTER_WATERFALL_BITS + 7) / 8];
+	unsigned int  g_panadapter_waterfall_newest;
+	unsigned int  g_panadapter_waterfall_count;
+#endif
 int           panadapter_rssi_index;     //
 int           panadapter_delay;          // used to give the VCO/PLL/RSSI time to settle
 
 const uint8_t panadapter_min_rssi = (-147 + 160) * 2;  // -147dBm (S0) min RSSI value
 
+#ifdef ENABLE_PANADAPTER_SPAN
+	const uint32_t PANADAPTER_SPAN_TABLE[PANADAPTER_SPAN_AUTO]    = {2500, 5000, 10000, 25000, 50000, 100000, 250000};  // +-25kHz ~ +-2.5MHz
+	const uint16_t PANADAPTER_SPACING_TABLE[PANADAPTER_SPAN_AUTO] = {125, 250, 625, 1250, 2500, 5000, 10000};            // 1.25kHz ~ 100kHz
+
+	// the sweep starts just above the VFO, runs up to the top, jumps to the bottom and runs back up
+	// to the VFO .. so there's only the one big PLL jump per sweep, the VFO pause is a bin away
+	#define PANADAPTER_FIRST_INDEX   (PANADAPTER_BINS + 1)
+#else
+	#define PANADAPTER_FIRST_INDEX   0
+#endif
+
 inline void PAN_restart(const bool full)
 {
 	if (full)
+	{
 		g_panadapter_cycles = 0;
-	panadapter_rssi_index = 0;
+		#ifdef ENABLE_PANADAPTER_WATERFALL
+			g_panadapter_waterfall_count = 0;   // it's out of date
+		#endif
+	}
+	panadapter_rssi_index = PANADAPTER_FIRST_INDEX;
 	panadapter_delay      = 3;
 }
 
+static int32_t PAN_bin_spacing(int *p_bins)
+{	// the frequency step between bins, and the number of bins either side of the VFO
+
+	int32_t spacing = g_tx_vfo->step_freq;
+	int     bins    = PANADAPTER_BINS;
+
+	// limit the step size
+	spacing = (spacing < PANADAPTER_MIN_STEP) ? PANADAPTER_MIN_STEP : (spacing > PANADAPTER_MAX_STEP) ? PANADAPTER_MAX_STEP : spacing;
+
+	#ifdef ENABLE_PANADAPTER_SPAN
+	{
+		const unsigned int span_index    = g_eeprom.config.setting.panadapter_span;
+		const unsigned int spacing_index = g_eeprom.config.setting.panadapter_spacing;
+
+		if (spacing_index < PANADAPTER_SPAN_AUTO)
+			spacing = PANADAPTER_SPACING_TABLE[spacing_index];
+
+		if (span_index < PANADAPTER_SPAN_AUTO)
+		{
+			const int32_t span = PANADAPTER_SPAN_TABLE[span_index];
+
+			if (spacing_index >= PANADAPTER_SPAN_AUTO)
+			{	// spread the bins across the span
+				spacing = (span + PANADAPTER_BINS - 1) / PANADAPTER_BINS;
+				if (spacing < PANADAPTER_SPACING_TABLE[0])
+					spacing = PANADAPTER_SPACING_TABLE[0];
+			}
+
+			// a span with more bins than there are LCD columns is trimmed down to fit
+			bins = span / spacing;
+			bins = (bins < 1) ? 1 : (bins > PANADAPTER_BINS) ? PANADAPTER_BINS : bins;
+		}
+	}
+	#endif
+
+	if (p_bins != NULL)
+		*p_bins = bins;
+
+	return spacing;
+}
+
+static int32_t PAN_bin_offset(const int index)
+{	// frequency offset from the VFO of the bin shown in LCD column 'index'
+
+	int           bins;
+	const int32_t spacing = PAN_bin_spacing(&bins);
+	int           bin     = index - PANADAPTER_BINS;
+
+	if (bins < PANADAPTER_BINS)
+	{	// fewer bins than columns, neighbouring columns share a bin
+		const int half = (bin < 0) ? -(PANADAPTER_BINS / 2) : PANADAPTER_BINS / 2;
+		bin = ((bin * bins) + half) / PANADAPTER_BINS;
+	}
+
+	return spacing * bin;
+}
+
+#ifdef ENABLE_PANADAPTER_SPAN
+	static BK4819_filter_bandwidth_t PAN_filter_bandwidth(void)
+	{	// match the RX filter to the bin spacing while sweeping, the VFO's own filter when on the VFO/center frequency
+
+		if (g_panadapter_enabled && g_panadapter_vfo_tick <= 0)
+		{
+			const int32_t spacing = PAN_bin_spacing(NULL);
+			return (spacing <= 625) ? BK4819_FILTER_BW_NARROWER : (spacing <= 1250) ? BK4819_FILTER_BW_NARROW : BK4819_FILTER_BW_WIDE;
+		}
+
+		// as RADIO_set_bandwidth() sets it
+		if (g_rx_vfo->channel.mod_mode == MOD_MODE_DSB)
+			return BK4819_FILTER_BW_NARROWER;
+		return (BK4819_filter_bandwidth_t)g_rx_vfo->channel.channel_bandwidth;
+	}
+#endif
+
 bool PAN_scanning(void)
 {
 	return (g_eeprom.config.setting.panadapter && g_panadapter_enabled && g_panadapter_vfo_tick <= 0) ? true : false;
 }
 
+static void PAN_store_rssi(const unsigned int bin, const uint8_t rssi)
+{
+	g_panadapter_rssi[bin] = rssi;
+
+	#ifdef ENABLE_PANADAPTER_AVG_PEAK
+	{
+		const int32_t diff = ((int32_t)rssi << 8) - g_panadapter_avg_rssi[bin];
+		const uint8_t peak = g_panadapter_peak_rssi[bin];
+
+		if (g_panadapter_cycles == 0)
+		{	// first sweep, start from here
+			g_panadapter_avg_rssi[bin]  = (uint16_t)rssi << 8;
+			g_panadapter_peak_rssi[bin] = rssi;
+			return;
+		}
+
+		// exponential average
+		g_panadapter_avg_rssi[bin] += diff >> PANADAPTER_AVG_SHIFT;
+
+		// peak hold, falls 1/8th of the way back down each sample (at least 1)
+		g_panadapter_peak_rssi[bin] = (rssi >= peak) ? rssi : peak - ((peak - rssi + 7) >> 3);
+	}
+	#endif
+}
+
+static inline uint8_t PAN_trace_rssi(const unsigned int bin)
+{	// the trace the scaling and peak search go by
+	#ifdef ENABLE_PANADAPTER_AVG_PEAK
+		return (g_panadapter_avg_rssi[bin] + 128) >> 8;
+	#else
+		return g_panadapter_rssi[bin];
+	#endif
+}
+
 void PAN_update_min_max(void)
 {	// compute the min/max RSSI values
 
-	register unsigned int   i;
-	register const uint8_t *p        = g_panadapter_rssi;
-	register uint8_t        max_rssi = *p;
-	register uint8_t        min_rssi = *p++;
+	unsigned int i;
+	uint8_t      max_rssi = PAN_trace_rssi(0);
+	uint8_t      min_rssi = max_rssi;
 
-	for (i = ARRAY_SIZE(g_panadapter_rssi) - 1; i > 0; i--)
+	for (i = 1; i < ARRAY_SIZE(g_panadapter_rssi); i++)
 	{
-		const uint8_t rssi = *p++;
+		const uint8_t rssi = PAN_trace_rssi(i);
 		if (max_rssi < rssi) max_rssi = rssi;
 		if (min_rssi > rssi) min_rssi = rssi;
 	}
@@ -65,12 +197,56 @@ void PAN_update_min_max(void)
 	g_panadapter_min_rssi = min_rssi;
 }
 
+void PAN_get_scale(uint8_t *p_min_rssi, uint8_t *p_span_rssi)
+{	// auto vertical scale
+	uint8_t min_rssi  = g_panadapter_min_rssi;
+	uint8_t span_rssi = g_panadapter_max_rssi - min_rssi;
+
+	if (span_rssi < 30)
+		span_rssi = 30;
+	if (min_rssi > (255 - span_rssi))
+		min_rssi =  255 - span_rssi;
+
+	*p_min_rssi  = min_rssi;
+	*p_span_rssi = span_rssi;
+}
+
+#ifdef ENABLE_PANADAPTER_WATERFALL
+	static void PAN_waterfall_add(void)
+	{	// quantise the sweep against the trace's scale and add it to the history
+
+		uint8_t     *row;
+		uint8_t      min_rssi;
+		uint8_t      span_rssi;
+		unsigned int i;
+
+		PAN_get_scale(&min_rssi, &span_rssi);
+
+		g_panadapter_waterfall_newest = (g_panadapter_waterfall_newest + 1) % PANADAPTER_WATERFALL_LINES;
+		if (g_panadapter_waterfall_count < PANADAPTER_WATERFALL_LINES)
+			g_panadapter_waterfall_count++;
+
+		row = g_panadapter_waterfall[g_panadapter_waterfall_newest];
+		memset(row, 0, sizeof(g_panadapter_waterfall[0]));
+
+		for (i = 0; i < ARRAY_SIZE(g_panadapter_rssi); i++)
+		{
+			const unsigned int bit   = i * PANADAPTER_WATERFALL_BITS;
+			const uint8_t      rssi  = g_panadapter_rssi[i];
+			unsigned int       level = (rssi <= min_rssi) ? 0 : ((unsigned int)(rssi - min_rssi) * (PANADAPTER_WATERFALL_MAX + 1)) / span_rssi;
+			if (level > PANADAPTER_WATERFALL_MAX)
+				level = PANADAPTER_WATERFALL_MAX;
+			row[bit / 8] |= level << (bit % 8);
+		}
+	}
+#endif
+
 #ifdef ENABLE_PANADAPTER_PEAK_FREQ
 	void PAN_find_peak(void)
 	{	// find the peak frequency
 
 		const int32_t center_freq = g_tx_vfo->p_rx->frequency;
-		int32_t step_size = g_tx_vfo->step_freq;
+		const int32_t spacing     = PAN_bin_spacing(NULL);
 
 		int i;
 
@@ -83,16 +259,14 @@ void PAN_update_min_max(void)
 			span_rssi = 80;
 		threshold_rssi = g_panadapter_min_rssi + (span_rssi / 4);
 
-		// limit the step size
-		step_size = (step_size < PANADAPTER_MIN_STEP) ? PANADAPTER_MIN_STEP : (step_size > PANADAPTER_MAX_STEP) ? PANADAPTER_MAX_STEP : step_size;
-
 		for (i = 0; i < (int)ARRAY_SIZE(g_panadapter_rssi); i++)
-		{
-			const uint8_t rssi = g_panadapter_rssi[i];
-			if (peak_rssi < rssi && rssi >= threshold_rssi && (i < (PANADAPTER_BINS - 1) || i > (PANADAPTER_BINS + 1)))
+		{	// ignore the bins either side of the VFO
+			const uint8_t rssi   = PAN_trace_rssi(i);
+			const int32_t offset = PAN_bin_offset(i);
+			if (peak_rssi < rssi && rssi >= threshold_rssi && (offset < -spacing || offset > spacing))
 			{
 				peak_rssi = rssi;
-				peak_freq = center_freq + (step_size * (i - PANADAPTER_BINS));
+				peak_freq = center_freq + offset;
 			}
 		}
 
@@ -110,18 +284,15 @@ void PAN_set_freq(void)
 
 	// if not paused on the VFO/center freq, add the panadapter bin offset frequency
 	if (g_panadapter_enabled && g_panadapter_vfo_tick <= 0)
-	{
-		int32_t step_size = g_tx_vfo->step_freq;
-
-		// limit the step size
-		step_size = (step_size < PANADAPTER_MIN_STEP) ? PANADAPTER_MIN_STEP : (step_size > PANADAPTER_MAX_STEP) ? PANADAPTER_MAX_STEP : step_size;
-
-		freq += step_size * (panadapter_rssi_index - PANADAPTER_BINS);
-	}
+		freq += PAN_bin_offset(panadapter_rssi_index);
 
 	BK4819_set_rf_frequency(freq, true);  // set the VCO/PLL
 	//BK4819_set_rf_filter_path(freq);    // set the proper LNA/PA filter path .. don't bother, we're not moving far from the VFO/center frequency
 
+	#ifdef ENABLE_PANADAPTER_SPAN
+		BK4819_SetFilterBandwidth(PAN_filter_bandwidth());
+	#endif
+
 	#ifdef ENABLE_AM_FIX
 		// set front end gains
 		if (g_panadapter_vfo_tick <= 0 || g_tx_vfo->channel.mod_mode == MOD_MODE_FM)
@@ -131,6 +302,16 @@ void PAN_set_freq(void)
 	#endif
 }
 
+static int PAN_settle_ticks(void)
+{	// 10ms ticks to wait after a big frequency jump
+	#ifdef ENABLE_SCAN_SETTLE_CAL
+		const unsigned int settle_us = RADIO_settle_us(g_tx_vfo->p_rx->frequency);
+		if (settle_us > 0)
+			return settle_us / 10000;  // the next tick is already 10ms away
+	#endif
+	return 3;  // give the VCO/PLL/RSSI a little more time to settle
+}
+
 void PAN_process_10ms(void)
 {
 	if (!g_eeprom.config.setting.panadapter         ||
@@ -186,7 +367,7 @@ void PAN_process_10ms(void)
 
 		// save the current RSSI value into the center of the panadapter
 		const int16_t rssi = g_current_rssi[g_eeprom.config.setting.tx_vfo_num];
-		g_panadapter_rssi[PANADAPTER_BINS] = (rssi > 255) ? 255 : (rssi < panadapter_min_rssi) ? panadapter_min_rssi : rssi;
+		PAN_store_rssi(PANADAPTER_BINS, (rssi > 255) ? 255 : (rssi < panadapter_min_rssi) ? panadapter_min_rssi : rssi);
 
 		PAN_update_min_max();
 
@@ -208,7 +389,11 @@ void PAN_process_10ms(void)
 
 		// back to scan/sweep mode
 		PAN_set_freq();
-		panadapter_delay = 3;  // give the VCO/PLL/RSSI a little more time to settle
+		#ifdef ENABLE_PANADAPTER_SPAN
+			panadapter_delay = 1;  // only a bin away
+		#else
+			panadapter_delay = PAN_settle_ticks();
+		#endif
 	}
 
 	// scanning/sweeping
@@ -219,14 +404,27 @@ void PAN_process_10ms(void)
 	panadapter_delay = 0;
 
 	// save the current RSSI value into the panadapter
-	const uint16_t rssi = BK4819_GetRSSI();
-	g_panadapter_rssi[panadapter_rssi_index] = (rssi > 255) ? 255 : (rssi < panadapter_min_rssi) ? panadapter_min_rssi : rssi;
+	const uint16_t rssi     = BK4819_GetRSSI();
+	const uint8_t  bin_rssi = (rssi > 255) ? 255 : (rssi < panadapter_min_rssi) ? panadapter_min_rssi : rssi;
+	PAN_store_rssi(panadapter_rssi_index, bin_rssi);
+
+	#ifdef ENABLE_PANADAPTER_SPAN
+	{	// the following columns showing the same bin get the same sample, rather than sweeping it again
+		const int32_t offset = PAN_bin_offset(panadapter_rssi_index);
+		int           next;
+		while ((next = (panadapter_rssi_index + 1) % (int)ARRAY_SIZE(g_panadapter_rssi)) != PANADAPTER_FIRST_INDEX && PAN_bin_offset(next) == offset)
+		{
+			PAN_store_rssi(next, bin_rssi);
+			panadapter_rssi_index = next;
+		}
+	}
+	#endif
 
 	// next scan/sweep frequency
 	if (++panadapter_rssi_index >= (int)ARRAY_SIZE(g_panadapter_rssi))
 	{
 		panadapter_rssi_index = 0;
-		panadapter_delay      = 3;  // give the VCO/PLL/RSSI a little more time to settle
+		panadapter_delay      = PAN_settle_ticks();
 	}
 
 //	if (g_tx_vfo->channel.mod_mode == MOD_MODE_FM && g_panadapter_cycles > 0)
@@ -235,13 +433,13 @@ void PAN_process_10ms(void)
 //	}
 //	else
 	{	// switch back to the VFO/center frequency for 100ms once per full sweep/scan cycle
-		g_panadapter_vfo_tick = (panadapter_rssi_index == 0) ? 10 : 0;
+		g_panadapter_vfo_tick = (panadapter_rssi_index == PANADAPTER_FIRST_INDEX) ? 10 : 0;
 	}
 
 	// set the VCO/PLL frequency
 	PAN_set_freq();
 
-	if (panadapter_rssi_index != 0)
+	if (panadapter_rssi_index != PANADAPTER_FIRST_INDEX)
 		return;
 
 	// completed a full sweep/scan, draw the panadapter on-screen
@@ -255,6 +453,10 @@ void PAN_process_10ms(void)
 		PAN_find_peak();
 	#endif
 
+	#ifdef ENABLE_PANADAPTER_WATERFALL
+		PAN_waterfall_add();
+	#endif
+
 	if (!g_dtmf_input_mode)
 		UI_DisplayMain_pan(true);
 //	else
@@ -28,6 +28,15 @@
 #define PANADAPTER_MAX_STEP    2500    // 25kHz
 #define PANADAPTER_MIN_STEP    500     // 5kHz
 
+#ifdef ENABLE_PANADAPTER_SPAN
+	// the user chosen span (either side of the VFO) and bin spacing, 10Hz units
+	// the setting after the last table entry (as erased) is 'auto' .. the old VFO step based sweep
+	#define PANADAPTER_SPAN_AUTO   7
+
+	extern const uint32_t PANADAPTER_SPAN_TABLE[PANADAPTER_SPAN_AUTO];
+	extern const uint16_t PANADAPTER_SPACING_TABLE[PANADAPTER_SPAN_AUTO];
+#endif
+
 extern bool         g_panadapter_enabled;
 extern unsigned int g_panadapter_cycles;
 extern uint32_t     g_panadapter_peak_freq;
@@ -36,7 +45,32 @@ extern uint8_t      g_panadapter_rssi[PANADAPTER_BINS + 1 + PANADAPTER_BINS];
 extern uint8_t      g_panadapter_max_rssi;
 extern uint8_t      g_panadapter_min_rssi;
 
+#ifdef ENABLE_PANADAPTER_AVG_PEAK
+	#define PANADAPTER_AVG_SHIFT   2   // each new sample moves the average 1/4 of the way to it
+
+	extern uint16_t     g_panadapter_avg_rssi[PANADAPTER_BINS + 1 + PANADAPTER_BINS];    // 8.8 fixed point
+	extern uint8_t      g_panadapter_peak_rssi[PANADAPTER_BINS + 1 + PANADAPTER_BINS];   // decaying peak hold
+#endif
+
+#ifdef ENABLE_PANADAPTER_WATERFALL
+	// the last few sweeps, packed PANADAPTER_WATERFALL_BITS per bin
+	#define PANADAPTER_WATERFALL_LINES   16   // a pixel row each, two LCD lines
+	#define PANADAPTER_WATERFALL_BITS    2    // 1, 2 or 4
+	#define PANADAPTER_WATERFALL_MAX     ((1u << PANADAPTER_WATERFALL_BITS) - 1)
+
+	extern uint8_t      g_panadapter_waterfall[PANADAPTER_WATERFALL_LINES][((PANADAPTER_BINS + 1 + PANADAPTER_BINS) * PANADAPTER_WATERFALL_BITS + 7) / 8];
+	extern unsigned int g_panadapter_waterfall_newest;   // index of the latest sweep
+	extern unsigned int g_panadapter_waterfall_count;    // sweeps held
+
+	static inline unsigned int PAN_waterfall_level(const uint8_t *row, const unsigned int bin)
+	{	// 0 ~ PANADAPTER_WATERFALL_MAX
+		const unsigned int bit = bin * PANADAPTER_WATERFALL_BITS;
+		return (row[bit / 8] >> (bit % 8)) & PANADAPTER_WATERFALL_MAX;
+	}
+#endif
+
 void PAN_restart(const bool full);
+void PAN_get_scale(uint8_t *p_min_rssi, uint8_t *p_span_rssi);
 bool PAN_scanning(void);
 void PAN_process_10ms(void);
 
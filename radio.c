@@ -14,6 +14,8 @@
  *     limitations under the License.
  */
 
+#include <string.h>     // memcmp, memcpy
+
 #include "app/app.h"
 #include "app/dtmf.h"
 #ifdef ENABLE_FMRADIO
@@ -30,6 +32,9 @@
 #include "driver/eeprom.h"
 #include "driver/gpio.h"
 #include "driver/system.h"
+#ifdef ENABLE_SCAN_SETTLE_CAL
+	#include "driver/systick.h"
+#endif
 #if defined(ENABLE_UART) && defined(ENABLE_UART_DEBUG)
 	#include "driver/uart.h"
 #endif
@@ -57,6 +62,9 @@ dcs_code_type_t g_current_code_type;
 uint8_t         g_selected_code;
 vfo_state_t     g_vfo_state[2];
 
+// the BK4819 register image built for the VFO, then sent in one go
+static BK4819_reg_pair_t radio_regs[48];
+
 bool RADIO_channel_valid(uint16_t Channel, bool bCheckScanList, uint8_t VFO)
 {	// return true if the channel appears valid
 
@@ -103,25 +111,99 @@ bool RADIO_channel_valid(uint16_t Channel, bool bCheckScanList, uint8_t VFO)
 	return true;
 }
 
+// user channel bitmaps, so finding the next channel doesn't mean walking all 200 channel attributes
+#define RADIO_CHAN_BITMAP_WORDS   ((USER_CHANNEL_LAST + 32) / 32)
+
+static uint32_t radio_chan_valid[RADIO_CHAN_BITMAP_WORDS];        // any used channel
+static uint32_t radio_chan_scanlist[2][RADIO_CHAN_BITMAP_WORDS];  // used channels in scan list 1/2
+
+void RADIO_update_channel_bitmap(const unsigned int channel)
+{	// call after changing the channels attributes
+	const unsigned int     index = channel >> 5;
+	const uint32_t         mask  = 1u << (channel & 31);
+	const t_channel_attrib att   = g_eeprom.config.channel_attributes[channel];
+	const bool             valid = (att.band <= BAND7_470MHz) ? true : false;
+
+	if (channel > USER_CHANNEL_LAST)
+		return;
+
+	radio_chan_valid[index]       &= ~mask;
+	radio_chan_scanlist[0][index] &= ~mask;
+	radio_chan_scanlist[1][index] &= ~mask;
+
+	if (valid)
+		radio_chan_valid[index] |= mask;
+	if (valid && att.scanlist1)
+		radio_chan_scanlist[0][index] |= mask;
+	if (valid && att.scanlist2)
+		radio_chan_scanlist[1][index] |= mask;
+}
+
+void RADIO_build_channel_bitmaps(void)
+{	// call after (re)loading all the channel attributes
+	unsigned int channel;
+	for (channel = 0; channel <= USER_CHANNEL_LAST; channel++)
+		RADIO_update_channel_bitmap(channel);
+}
+
+static int RADIO_bitmap_find(const uint32_t *bitmap, int channel, const int direction)
+{	// find the next set bit from 'channel' on in 'direction', -1 if we run off the end
+	while (channel >= 0 && channel <= USER_CHANNEL_LAST)
+	{
+		const uint32_t word = bitmap[channel >> 5];
+
+		if (word == 0)
+		{	// skip the whole word
+			channel = (direction > 0) ? (channel | 31) + 1 : (channel & ~31) - 1;
+			continue;
+		}
+
+		if (word & (1u << (channel & 31)))
+			return channel;
+
+		channel += direction;
+	}
+
+	return -1;
+}
+
 uint8_t RADIO_FindNextChannel(uint8_t Channel, scan_state_dir_t Direction, bool bCheckScanList, uint8_t VFO)
 {
-	unsigned int i;
+	uint32_t bitmap[RADIO_CHAN_BITMAP_WORDS];
+	int      found;
 
-	for (i = 0; i <= USER_CHANNEL_LAST; i++)
-	{
-		if (Channel == 0xFF)
-			Channel = USER_CHANNEL_LAST;
-		else
-		if (Channel > USER_CHANNEL_LAST)
-			Channel = USER_CHANNEL_FIRST;
+	if (Channel == 0xFF)
+		Channel = USER_CHANNEL_LAST;
+	else
+	if (Channel > USER_CHANNEL_LAST)
+		Channel = USER_CHANNEL_FIRST;
 
-		if (RADIO_channel_valid(Channel, bCheckScanList, VFO))
-			return Channel;
+	if (Direction == SCAN_STATE_DIR_OFF)
+		return RADIO_channel_valid(Channel, bCheckScanList, VFO) ? Channel : 0xFF;
 
-		Channel += Direction;
+	if (bCheckScanList && VFO < 2)
+	{	// scan list channels, less that lists priority channels
+		unsigned int i;
+
+		memcpy(bitmap, radio_chan_scanlist[VFO], sizeof(bitmap));
+
+		for (i = 0; i < 2; i++)
+		{
+			const unsigned int chan = g_eeprom.config.setting.priority_scan_list[VFO].channel[i];
+			if (chan <= USER_CHANNEL_LAST)
+				bitmap[chan >> 5] &= ~(1u << (chan & 31));
+		}
+	}
+	else
+	{
+		memcpy(bitmap, radio_chan_valid, sizeof(bitmap));
 	}
 
-	return 0xFF;
+	found = RADIO_bitmap_find(bitmap, Channel, Direction);
+	if (found < 0)   // wrap around
+		found = RADIO_bitmap_find(bitmap, (Direction > 0) ? USER_CHANNEL_FIRST : USER_CHANNEL_LAST, Direction);
+
+	return (found < 0) ? 0xFF : (uint8_t)found;
 }
 
 void RADIO_InitInfo(vfo_info_t *p_vfo, const uint8_t ChannelSave, const uint32_t Frequency)
@@ -163,6 +245,10 @@ void RADIO_configure_channel(const unsigned int VFO, const unsigned int configur
 	uint32_t         frequency;
 	vfo_info_t      *p_vfo = &g_vfo_info[VFO];
 
+	#ifdef ENABLE_VFO_REG_IMAGES
+		RADIO_invalidate_vfo_image(VFO);
+	#endif
+
 	if (!g_eeprom.config.setting.enable_350)
 	{
 		if (g_eeprom.config.setting.indices.vfo[VFO].frequency == (FREQ_CHANNEL_LAST - 2))
@@ -212,6 +298,10 @@ void RADIO_configure_channel(const unsigned int VFO, const unsigned int configur
 
 	chan = CHANNEL_NUM(channel, VFO);
 
+	#ifdef ENABLE_EEPROM_LAZY_LOAD
+		SETTINGS_load_channel(channel);   // in case it's not been read in yet
+	#endif
+
 	attributes = g_eeprom.config.channel_attributes[channel];
 
 	#if defined(ENABLE_UART) && defined(ENABLE_UART_DEBUG)
@@ -440,6 +530,10 @@ void RADIO_ConfigureSquelch(vfo_info_t *p_vfo)
 {
 	const unsigned int squelch_level = (p_vfo->channel.squelch_level > 0 && p_vfo->channel.squelch_level < 10) ? p_vfo->channel.squelch_level : g_eeprom.config.setting.squelch_level;
 
+	#ifdef ENABLE_VFO_REG_IMAGES
+		RADIO_invalidate_vfo_image((p_vfo == &g_vfo_info[0]) ? 0 : 1);
+	#endif
+
 	// note that 'noise' and 'glitch' values are inverted compared to 'rssi' values
 
 	// peters readings, all on 156.550
@@ -748,58 +842,234 @@ BK4819_filter_bandwidth_t RADIO_set_bandwidth(BK4819_filter_bandwidth_t bandwidt
 	return bandwidth;
 }
 
-void RADIO_setup_registers(bool switch_to_function_foreground)
-{
-	BK4819_filter_bandwidth_t Bandwidth = g_rx_vfo->channel.channel_bandwidth;
-	uint16_t                  interrupt_mask;
-	uint32_t                  Frequency;
+#ifdef ENABLE_VFO_REG_IMAGES
+	// the RX register image of each VFO
+	//
+	// built the first time the VFO is received on, then replayed as it is (dual-watch switches,
+	// back from TX etc) until RADIO_configure_channel(), the squelch or a settings save changes it
 
-	if (!g_monitor_enabled)
+	typedef struct {
+		uint32_t          frequency;    // the RX frequency the image was built for
+		uint8_t           count;        // 0 = needs building
+		BK4819_reg_pair_t regs[40];
+	} radio_vfo_image_t;
+
+	static radio_vfo_image_t radio_vfo_images[2];
+
+	static radio_vfo_image_t * RADIO_vfo_image(void)
+	{	// the RX VFO's image, but only when the RX setup depends on nothing but the VFO
+		if (g_monitor_enabled || g_css_scan_mode != CSS_SCAN_MODE_OFF)
+			return NULL;
+		#ifdef ENABLE_FMRADIO
+			if (g_fm_radio_mode || g_request_display_screen == DISPLAY_FM)
+				return NULL;
+		#endif
+		#if defined(ENABLE_VOICE) && defined(MUTE_AUDIO_FOR_VOICE)
+			if (g_voice_write_index != 0)
+				return NULL;
+		#endif
+		return &radio_vfo_images[(g_rx_vfo == &g_vfo_info[0]) ? 0 : 1];
+	}
+
+	static bool RADIO_replay_vfo_image(const uint32_t Frequency)
+	{
+		const radio_vfo_image_t *image = RADIO_vfo_image();
+
+		if (image == NULL || image->count == 0 || image->frequency != Frequency)
+			return false;
+
+		// the GPIO pins aren't in the image, they also hold the LED's
+		BK4819_set_rf_filter_path(Frequency);
+		BK4819_set_GPIO_pin(BK4819_GPIO0_PIN28_RX_ENABLE, true);
+
+		BK4819_write_regs(image->regs, image->count);
+		return true;
+	}
+
+	static void RADIO_store_vfo_image(const uint32_t Frequency, const unsigned int count)
+	{	// keep a copy of the RX setup just recorded into 'radio_regs'
+		radio_vfo_image_t *image = RADIO_vfo_image();
+		unsigned int       i;
+
+		if (image == NULL)
+			return;
+
+		image->count = 0;
+
+		for (i = 0; i < count; i++)
+		{
+			if (radio_regs[i].reg == 0x33)
+				continue;      // GPIO's
+			if (image->count >= ARRAY_SIZE(image->regs))
+			{	// too big to keep
+				image->count = 0;
+				return;
+			}
+			image->regs[image->count++] = radio_regs[i];
+		}
+
+		image->frequency = Frequency;
+	}
+
+	void RADIO_invalidate_vfo_image(const unsigned int VFO)
+	{
+		radio_vfo_images[VFO & 1u].count = 0;
+	}
+#endif
+
+#ifdef ENABLE_SCAN_REG_IMAGES
+	// the RX register images of the last few channel configurations seen while channel scanning
+	//
+	// a channel scan hops around channels that mostly share the same settings, so rather than
+	// rebuilding the whole RX setup on every hop we replay a stored image with the new frequency
+	// patched in .. there's no RAM for an image per channel, so they're keyed on the settings
+
+	typedef struct {
+		uint8_t mod_mode;
+		uint8_t bandwidth;
+		uint8_t code_type;
+		uint8_t code;
+		uint8_t scrambler;
+		uint8_t compand;
+		uint8_t squelch[6];
+	} radio_image_key_t;
+
+	typedef struct {
+		radio_image_key_t key;
+		uint8_t           count;        // 0 = empty slot
+		uint8_t           freq_index;   // where the 0x38/0x39 pair is in 'regs'
+		BK4819_reg_pair_t regs[40];
+	} radio_image_t;
+
+	static radio_image_t radio_images[2];
+	static unsigned int  radio_image_next;
+
+	static void RADIO_invalidate_scan_images(void)
 	{
+		unsigned int i;
+		for (i = 0; i < ARRAY_SIZE(radio_images); i++)
+			radio_images[i].count = 0;
+	}
+
+	static bool RADIO_image_usable(void)
+	{	// only while channel scanning, and only when the RX setup depends on nothing but the channel
+		if (g_scan_state_dir == SCAN_STATE_DIR_OFF || !IS_USER_CHANNEL(g_rx_vfo->channel_save))
+			return false;
+		if (g_monitor_enabled || g_css_scan_mode != CSS_SCAN_MODE_OFF)
+			return false;
 		#ifdef ENABLE_FMRADIO
-			if (!g_fm_radio_mode && g_request_display_screen != DISPLAY_FM)
+			if (g_fm_radio_mode || g_request_display_screen == DISPLAY_FM)
+				return false;
 		#endif
-				GPIO_ClearBit(&GPIOC->DATA, GPIOC_PIN_SPEAKER);   // speaker off
+		#if defined(ENABLE_VOICE) && defined(MUTE_AUDIO_FOR_VOICE)
+			if (g_voice_write_index != 0)
+				return false;
+		#endif
+		return true;
 	}
 
-	// green LED off
-	BK4819_set_GPIO_pin(BK4819_GPIO6_PIN2_GREEN, false);
+	static void RADIO_image_key(radio_image_key_t *key)
+	{
+		memset(key, 0, sizeof(*key));
+		key->mod_mode   = g_rx_vfo->channel.mod_mode;
+		key->bandwidth  = g_rx_vfo->channel.channel_bandwidth;
+		key->code_type  = g_rx_vfo->p_rx->code_type;
+		key->code       = g_rx_vfo->p_rx->code;
+		key->scrambler  = g_rx_vfo->channel.scrambler;
+		key->compand    = g_rx_vfo->channel.compand;
+		key->squelch[0] = g_rx_vfo->squelch_open_rssi_thresh;
+		key->squelch[1] = g_rx_vfo->squelch_close_rssi_thresh;
+		key->squelch[2] = g_rx_vfo->squelch_open_noise_thresh;
+		key->squelch[3] = g_rx_vfo->squelch_close_noise_thresh;
+		key->squelch[4] = g_rx_vfo->squelch_open_glitch_thresh;
+		key->squelch[5] = g_rx_vfo->squelch_close_glitch_thresh;
+	}
 
-	Bandwidth = RADIO_set_bandwidth(Bandwidth, g_rx_vfo->channel.mod_mode);
+	static bool RADIO_replay_image(const uint32_t Frequency)
+	{
+		radio_image_key_t key;
+		unsigned int      i;
 
-	BK4819_write_reg(0x30, 0);
-	BK4819_write_reg(0x30,
-		BK4819_REG_30_ENABLE_VCO_CALIB |
-//		BK4819_REG_30_ENABLE_UNKNOWN   |
-		BK4819_REG_30_ENABLE_RX_LINK   |
-		BK4819_REG_30_ENABLE_AF_DAC    |
-		BK4819_REG_30_ENABLE_DISC_MODE |
-		BK4819_REG_30_ENABLE_PLL_VCO   |
-//		BK4819_REG_30_ENABLE_PA_GAIN   |
-//		BK4819_REG_30_ENABLE_MIC_ADC   |
-//		BK4819_REG_30_ENABLE_TX_DSP    |
-		BK4819_REG_30_ENABLE_RX_DSP    |
-	0);
+		if (!RADIO_image_usable())
+			return false;
 
-	BK4819_set_GPIO_pin(BK4819_GPIO5_PIN1_RED, false);         // red LED off
-	BK4819_SetupPowerAmplifier(0, 0);                          //
-	BK4819_set_GPIO_pin(BK4819_GPIO1_PIN29_PA_ENABLE, false);  // PA off
+		RADIO_image_key(&key);
 
-	do {	// wait for interrupts to clear
-		const uint16_t int_bits = BK4819_read_reg(0x0C);
-		if ((int_bits & (1u << 0)) == 0)
-			break;
-		BK4819_write_reg(0x02, 0);   // clear the interrupt bits ?
-		SYSTEM_DelayMs(1);
-	} while (1);
-	BK4819_write_reg(0x3F, 0);       // disable interrupts
+		for (i = 0; i < ARRAY_SIZE(radio_images); i++)
+		{
+			radio_image_t *image = &radio_images[i];
 
-	#ifdef ENABLE_NOAA
-		if (IS_NOAA_CHANNEL(g_rx_vfo->channel_save) && g_noaa_mode)
-			Frequency = NOAA_FREQUENCY_TABLE[g_noaa_channel];
-		else
-	#endif
-			Frequency = g_rx_vfo->p_rx->frequency;
+			if (image->count == 0 || memcmp(&image->key, &key, sizeof(key)) != 0)
+				continue;
+
+			// the GPIO pins aren't in the image, they depend on the band
+			BK4819_set_rf_filter_path(Frequency);
+			BK4819_set_GPIO_pin(BK4819_GPIO0_PIN28_RX_ENABLE, true);
+
+			image->regs[image->freq_index + 0].value = (Frequency >>  0) & 0xFFFF;
+			image->regs[image->freq_index + 1].value = (Frequency >> 16) & 0xFFFF;
+
+			BK4819_write_regs(image->regs, image->count);
+			return true;
+		}
+
+		return false;
+	}
+
+	static void RADIO_store_image(const unsigned int count)
+	{	// keep a copy of the RX setup just recorded into 'radio_regs'
+		radio_image_t *image;
+		unsigned int   i;
+
+		if (count == 0 || !RADIO_image_usable())
+			return;
+
+		image = &radio_images[radio_image_next];
+		image->count      = 0;
+		image->freq_index = 0xff;
+
+		for (i = 0; i < count; i++)
+		{
+			if (radio_regs[i].reg == 0x33)
+				continue;      // GPIO's
+			if (image->count >= ARRAY_SIZE(image->regs))
+			{	// too big to keep
+				image->count = 0;
+				return;
+			}
+			if (radio_regs[i].reg == 0x38 && (i + 1) < count && radio_regs[i + 1].reg == 0x39 && image->freq_index == 0xff)
+				image->freq_index = image->count;
+			image->regs[image->count++] = radio_regs[i];
+		}
+
+		if (image->freq_index == 0xff)
+		{	// no frequency to patch
+			image->count = 0;
+			return;
+		}
+
+		RADIO_image_key(&image->key);
+
+		radio_image_next = (radio_image_next + 1) % ARRAY_SIZE(radio_images);
+	}
+#endif
+
+#if defined(ENABLE_SCAN_REG_IMAGES) || defined(ENABLE_VFO_REG_IMAGES)
+	void RADIO_invalidate_images(void)
+	{	// a setting they're built from has changed
+		#ifdef ENABLE_SCAN_REG_IMAGES
+			RADIO_invalidate_scan_images();
+		#endif
+		#ifdef ENABLE_VFO_REG_IMAGES
+			RADIO_invalidate_vfo_image(0);
+			RADIO_invalidate_vfo_image(1);
+		#endif
+	}
+#endif
+
+static void RADIO_setup_rx_registers(const uint32_t Frequency)
+{	// everything that depends on the RX VFO
+	uint16_t interrupt_mask;
 
 	// set VCO/PLL frequency
 	BK4819_set_rf_frequency(Frequency, true);
@@ -943,6 +1213,82 @@ void RADIO_setup_registers(bool switch_to_function_foreground)
 
 	// enable BK4819 interrupts
 	BK4819_write_reg(0x3F, interrupt_mask);
+}
+
+void RADIO_setup_registers(bool switch_to_function_foreground)
+{
+	BK4819_filter_bandwidth_t Bandwidth = g_rx_vfo->channel.channel_bandwidth;
+	uint32_t                  Frequency;
+
+	if (!g_monitor_enabled)
+	{
+		#ifdef ENABLE_FMRADIO
+			if (!g_fm_radio_mode && g_request_display_screen != DISPLAY_FM)
+		#endif
+				GPIO_ClearBit(&GPIOC->DATA, GPIOC_PIN_SPEAKER);   // speaker off
+	}
+
+	// green LED off
+	BK4819_set_GPIO_pin(BK4819_GPIO6_PIN2_GREEN, false);
+
+	Bandwidth = RADIO_set_bandwidth(Bandwidth, g_rx_vfo->channel.mod_mode);
+
+	BK4819_write_reg(0x30, 0);
+	BK4819_write_reg(0x30,
+		BK4819_REG_30_ENABLE_VCO_CALIB |
+//		BK4819_REG_30_ENABLE_UNKNOWN   |
+		BK4819_REG_30_ENABLE_RX_LINK   |
+		BK4819_REG_30_ENABLE_AF_DAC    |
+		BK4819_REG_30_ENABLE_DISC_MODE |
+		BK4819_REG_30_ENABLE_PLL_VCO   |
+//		BK4819_REG_30_ENABLE_PA_GAIN   |
+//		BK4819_REG_30_ENABLE_MIC_ADC   |
+//		BK4819_REG_30_ENABLE_TX_DSP    |
+		BK4819_REG_30_ENABLE_RX_DSP    |
+	0);
+
+	BK4819_set_GPIO_pin(BK4819_GPIO5_PIN1_RED, false);         // red LED off
+	BK4819_SetupPowerAmplifier(0, 0);                          //
+	BK4819_set_GPIO_pin(BK4819_GPIO1_PIN29_PA_ENABLE, false);  // PA off
+
+	do {	// wait for interrupts to clear
+		const uint16_t int_bits = BK4819_read_reg(0x0C);
+		if ((int_bits & (1u << 0)) == 0)
+			break;
+		BK4819_write_reg(0x02, 0);   // clear the interrupt bits ?
+		SYSTEM_DelayMs(1);
+	} while (1);
+	BK4819_write_reg(0x3F, 0);       // disable interrupts
+
+	#ifdef ENABLE_NOAA
+		if (IS_NOAA_CHANNEL(g_rx_vfo->channel_save) && g_noaa_mode)
+			Frequency = NOAA_FREQUENCY_TABLE[g_noaa_channel];
+		else
+	#endif
+			Frequency = g_rx_vfo->p_rx->frequency;
+
+	#ifdef ENABLE_VFO_REG_IMAGES
+		if (!RADIO_replay_vfo_image(Frequency))
+	#endif
+	#ifdef ENABLE_SCAN_REG_IMAGES
+		if (!RADIO_replay_image(Frequency))
+	#endif
+	{
+		unsigned int count;
+
+		BK4819_record_regs(radio_regs, ARRAY_SIZE(radio_regs));
+		RADIO_setup_rx_registers(Frequency);
+		count = BK4819_record_stop();
+
+		#ifdef ENABLE_VFO_REG_IMAGES
+			RADIO_store_vfo_image(Frequency, count);
+		#endif
+		#ifdef ENABLE_SCAN_REG_IMAGES
+			RADIO_store_image(count);
+		#endif
+
+		BK4819_write_regs(radio_regs, count);
+	}
 
 	FUNCTION_Init();
 
@@ -1002,12 +1348,89 @@ void RADIO_setup_registers(bool switch_to_function_foreground)
 	}
 #endif
 
+#ifdef ENABLE_SCAN_SETTLE_CAL
+	unsigned int RADIO_settle_us(const uint32_t frequency)
+	{	// the measured RSSI settle time after a retune in this frequencies band, 0 if not measured
+		const uint8_t settle = g_eeprom.calib.scan_settle_50us[FREQUENCY_GetBand(frequency)];
+		return (settle == 0xff) ? 0 : settle * 50u;
+	}
+
+	static unsigned int RADIO_measure_settle_us(const uint32_t from, const uint32_t to)
+	{	// jump from 'from' to 'to' and time how long it takes the RSSI to hold steady
+		const unsigned int max_us = 254 * 50;
+		unsigned int       time_us;
+		unsigned int       steady = 0;
+		uint16_t           prev_rssi;
+
+		BK4819_set_rf_frequency(from, true);
+		BK4819_set_rf_filter_path(from);
+		SYSTEM_DelayMs(20);
+
+		BK4819_set_rf_frequency(to, true);
+		BK4819_set_rf_filter_path(to);
+
+		prev_rssi = BK4819_GetRSSI();
+
+		for (time_us = 50; time_us < max_us; time_us += 50)
+		{
+			uint16_t rssi;
+
+			SYSTICK_Delay250ns(50 * 4);
+
+			rssi = BK4819_GetRSSI();
+			if ((rssi > prev_rssi ? rssi - prev_rssi : prev_rssi - rssi) > 2)
+				steady = 0;
+			else
+			if (++steady >= 4)   // steady over the last 4 samples, it settled at the first of them
+				return time_us - 150;
+			prev_rssi = rssi;
+		}
+
+		return max_us;
+	}
+
+	void RADIO_calibrate_settle(const unsigned int band)
+	{	// measure the worst case RSSI settle time for the band, RADIO_save_settle() once they're all done
+		const uint32_t lower = FREQ_BAND_TABLE[band].lower;
+		const uint32_t upper = FREQ_BAND_TABLE[band].upper;
+		const uint32_t f1    = lower + ((upper - lower) / 4);
+		const uint32_t f2    = upper - ((upper - lower) / 4);
+		unsigned int   settle_us = 0;
+		unsigned int   i;
+
+		for (i = 0; i < 4; i++)
+		{	// both directions, twice
+			const unsigned int us = (i & 1u) ? RADIO_measure_settle_us(f2, f1) : RADIO_measure_settle_us(f1, f2);
+			if (settle_us < us)
+				settle_us = us;
+		}
+
+		// plus a safety margin
+		settle_us += (settle_us / 4) + 100;
+		if (settle_us < scan_settle_min_us)
+			settle_us = scan_settle_min_us;
+
+		g_eeprom.calib.scan_settle_50us[band] = (settle_us >= (254 * 50)) ? 254 : (settle_us + 49) / 50;
+	}
+
+	void RADIO_save_settle(void)
+	{
+		const unsigned int index = (unsigned int)(((uint8_t *)&g_eeprom.calib.scan_settle_50us) - ((uint8_t *)&g_eeprom));
+		EEPROM_WriteBuffer8(index, ((uint8_t *)&g_eeprom) + index);
+
+		// back to where we were
+		RADIO_setup_registers(true);
+	}
+#endif
+
 void RADIO_enableTX(const bool fsk_tx)
 {
 	BK4819_filter_bandwidth_t Bandwidth = g_current_vfo->channel.channel_bandwidth;
 
 	GPIO_ClearBit(&GPIOC->DATA, GPIOC_PIN_SPEAKER);
 
+	BK4819_record_regs(radio_regs, ARRAY_SIZE(radio_regs));
+
 	BK4819_set_GPIO_pin(BK4819_GPIO0_PIN28_RX_ENABLE, false);
 
 	Bandwidth = RADIO_set_bandwidth(Bandwidth, g_current_vfo->channel.mod_mode);
@@ -1063,6 +1486,8 @@ void RADIO_enableTX(const bool fsk_tx)
 				break;
 		}
 	}
+
+	BK4819_write_regs(radio_regs, BK4819_record_stop());
 }
 
 void RADIO_set_vfo_state(vfo_state_t State)
@@ -1143,7 +1568,7 @@ void RADIO_PrepareTX(void)
 		else
 	#endif
 	#if defined(ENABLE_UART)
-		if (!g_eeprom.config.setting.tx_enable || g_serial_config_tick_500ms > 0)
+		if (!g_eeprom.config.setting.tx_enable || SCHEDULER_running(&g_serial_config_timer))
 	#else
 		if (!g_eeprom.config.setting.tx_enable)
 	#endif
@@ -36,6 +36,8 @@ extern uint8_t         g_selected_code;
 extern vfo_state_t     g_vfo_state[2];
 
 bool     RADIO_channel_valid(uint16_t ChNum, bool bCheckScanList, uint8_t RadioNum);
+void     RADIO_update_channel_bitmap(const unsigned int channel);
+void     RADIO_build_channel_bitmaps(void);
 uint8_t  RADIO_FindNextChannel(uint8_t ChNum, scan_state_dir_t Direction, bool bCheckScanList, uint8_t RadioNum);
 void     RADIO_InitInfo(vfo_info_t *p_vfo, const uint8_t ChannelSave, const uint32_t Frequency);
 void     RADIO_configure_channel(const unsigned int VFO, const unsigned int configure);
@@ -47,9 +49,20 @@ void     RADIO_ConfigureTXPower(vfo_info_t *p_vfo);
 void     RADIO_apply_offset(vfo_info_t *p_vfo, const bool set_pees);
 void     RADIO_select_vfos(void);
 void     RADIO_setup_registers(bool switch_to_function_foreground);
+#if defined(ENABLE_SCAN_REG_IMAGES) || defined(ENABLE_VFO_REG_IMAGES)
+	void RADIO_invalidate_images(void);
+#endif
+#ifdef ENABLE_VFO_REG_IMAGES
+	void RADIO_invalidate_vfo_image(const unsigned int VFO);
+#endif
 #ifdef ENABLE_NOAA
 	void RADIO_ConfigureNOAA(void);
 #endif
+#ifdef ENABLE_SCAN_SETTLE_CAL
+	unsigned int RADIO_settle_us(const uint32_t frequency);
+	void         RADIO_calibrate_settle(const unsigned int band);
+	void         RADIO_save_settle(void);
+#endif
 void     RADIO_enableTX(const bool fsk_tx);
 
 void     RADIO_set_vfo_state(vfo_state_t State);
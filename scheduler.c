@@ -22,73 +22,157 @@
 #include "functions.h"
 #include "helper/battery.h"
 #include "misc.h"
+#include "scheduler.h"
 #include "settings.h"
 
 #include "driver/backlight.h"
+#ifdef ENABLE_SLICE_STATS
+	#include "driver/systick.h"
+#endif
 #include "bsp/dp32g030/gpio.h"
 #include "driver/gpio.h"
 
-#define DECREMENT(cnt) \
-	do {               \
-		if (cnt > 0)   \
-			cnt--;     \
+#define DECREMENT(cnt, ticks)                  \
+	do {                                       \
+		cnt = (cnt > ticks) ? cnt - ticks : 0; \
 	} while (0)
 
-#define DECREMENT_AND_TRIGGER(cnt, flag) \
-	do {                                 \
-		if (cnt > 0)                     \
-			if (--cnt == 0)              \
-				flag = true;             \
+#define DECREMENT_AND_TRIGGER(cnt, ticks, flag) \
+	do {                                        \
+		if (cnt > 0)                            \
+		{                                       \
+			if (cnt > ticks)                    \
+				cnt -= ticks;                   \
+			else                                \
+			{                                   \
+				cnt  = 0;                       \
+				flag = true;                    \
+			}                                   \
+		}                                       \
 	} while (0)
 
+// timer wheel .. each timer sits in the slot its due tick falls in, timers due more
+// than a wheel turn away simply get passed over until their turn comes round
+#define SCHED_WHEEL_SIZE   16      // must be a power of 2
+
 static volatile uint32_t g_global_sys_tick_counter;
+static uint32_t          sched_dispatched_tick;   // last tick the main loop has dispatched
+static volatile bool     sched_pending;           // a wheel slot with timers in it has come round
+static sched_timer_t * volatile sched_wheel[SCHED_WHEEL_SIZE];
 
-void SystickHandler(void);
+#ifdef ENABLE_SLICE_STATS
+	sched_stats_t g_time_slice_stats[3];
 
-// we come here every 10ms
-void SystickHandler(void)
-{
-	g_global_sys_tick_counter++;
-	
-	g_next_time_slice = true;
+	void SCHEDULER_update_stats(sched_stats_t *stats, const uint32_t time_us, const uint32_t limit_us)
+	{
+		uint32_t     t   = time_us / 250;
+		unsigned int bin = 0;
+
+		while (t > 0 && bin < (SCHED_STATS_BINS - 1))
+		{
+			t >>= 1;
+			bin++;
+		}
+
+		stats->count++;
+		stats->last_us = time_us;
+		if (stats->worst_us < time_us)
+			stats->worst_us = time_us;
+		if (time_us > limit_us)
+			stats->overruns++;
+		stats->histogram[bin]++;
+	}
+#endif
 
-	if ((g_global_sys_tick_counter % 50) == 0)
-	{	// 500ms tick
+static void SCHEDULER_insert(sched_timer_t *timer, const uint32_t tick)
+{	// the interrupt only ever looks at the slot heads, so no need to mask it
+	sched_timer_t * volatile *slot = &sched_wheel[tick & (SCHED_WHEEL_SIZE - 1)];
 
-		g_next_time_slice_500ms = true;
-		
-		DECREMENT_AND_TRIGGER(g_tx_timer_tick_500ms, g_tx_timeout_reached);
+	timer->expire_tick = tick;
+	timer->next        = *slot;
+	*slot              = timer;
+
+	if ((int32_t)(tick - g_global_sys_tick_counter) <= 0)
+		sched_pending = true;   // its tick came round before we got it in
+}
+
+void SCHEDULER_stop(sched_timer_t *timer)
+{
+	sched_timer_t * volatile *link = &sched_wheel[timer->expire_tick & (SCHED_WHEEL_SIZE - 1)];
 
-		#if defined(ENABLE_UART)
-			DECREMENT(g_serial_config_tick_500ms);
-		#endif
+	while (*link != NULL)
+	{
+		if (*link == timer)
+		{
+			*link = timer->next;
+			break;
+		}
+		link = &(*link)->next;
 	}
 
-	if ((g_global_sys_tick_counter & 3) == 0)
-		g_next_time_slice_40ms = true;
+	timer->next = NULL;
+}
 
-	#ifdef ENABLE_NOAA
-		DECREMENT(g_noaa_tick_10ms);
-	#endif
+void SCHEDULER_start(sched_timer_t *timer, const uint32_t delay_10ms, const uint16_t period_10ms, sched_callback_t callback)
+{	// (re)start a timer, a delay of 0 leaves it stopped (same as the old countdowns)
+
+	SCHEDULER_stop(timer);
+
+	timer->period_10ms = period_10ms;
+	timer->callback    = callback;
+
+	if (delay_10ms > 0)
+		SCHEDULER_insert(timer, g_global_sys_tick_counter + delay_10ms);
+}
+
+bool SCHEDULER_running(const sched_timer_t *timer)
+{	// true if it's waiting to go off
+	const sched_timer_t *t = sched_wheel[timer->expire_tick & (SCHED_WHEEL_SIZE - 1)];
+
+	while (t != NULL && t != timer)
+		t = t->next;
+
+	return (t != NULL);
+}
+
+uint32_t SCHEDULER_remaining(const sched_timer_t *timer)
+{	// ticks till it goes off, 0 if it's not running
+	const int32_t ticks = (int32_t)(timer->expire_tick - g_global_sys_tick_counter);
+	return (ticks > 0 && SCHEDULER_running(timer)) ? (uint32_t)ticks : 0;
+}
+
+uint32_t SCHEDULER_ticks(void)
+{
+	return g_global_sys_tick_counter;
+}
 
-	DECREMENT(g_found_cdcss_tick_10ms);
+bool SCHEDULER_pending(void)
+{
+	return sched_pending;
+}
 
-	DECREMENT(g_found_ctcss_tick_10ms);
+static void SCHEDULER_countdowns(const uint32_t ticks)
+{	// the countdowns that only count down in particular radio states, they're caught up on
+	// here in the main loop (by however many ticks have gone by) rather than in the interrupt
+
+	#ifdef ENABLE_NOAA
+		DECREMENT(g_noaa_tick_10ms, ticks);
+	#endif
 
 	if (g_current_function == FUNCTION_FOREGROUND)
-		DECREMENT_AND_TRIGGER(g_power_save_pause_tick_10ms, g_power_save_pause_done);
+		DECREMENT_AND_TRIGGER(g_power_save_pause_tick_10ms, ticks, g_power_save_pause_done);
 
 	if (g_current_function == FUNCTION_POWER_SAVE)
-		DECREMENT_AND_TRIGGER(g_power_save_tick_10ms, g_power_save_expired);
+		DECREMENT_AND_TRIGGER(g_power_save_tick_10ms, ticks, g_power_save_expired);
 
 	if (g_eeprom.config.setting.dual_watch != DUAL_WATCH_OFF &&
 	    g_scan_state_dir == SCAN_STATE_DIR_OFF &&
 	    g_css_scan_mode == CSS_SCAN_MODE_OFF)
 	{
 		if (g_current_function == FUNCTION_FOREGROUND || g_current_function == FUNCTION_POWER_SAVE)
-			DECREMENT(g_dual_watch_tick_10ms);
+			DECREMENT(g_dual_watch_tick_10ms, ticks);
 	}
-		
+
 	#ifdef ENABLE_NOAA
 		if (g_scan_state_dir == SCAN_STATE_DIR_OFF &&
 		    g_css_scan_mode == CSS_SCAN_MODE_OFF &&
@@ -98,33 +182,95 @@ void SystickHandler(void)
 		    g_current_function != FUNCTION_TRANSMIT)
 		{
 			if (g_current_function != FUNCTION_RECEIVE)
-				DECREMENT_AND_TRIGGER(g_noaa_tick_10ms, g_schedule_noaa);
+				DECREMENT_AND_TRIGGER(g_noaa_tick_10ms, ticks, g_schedule_noaa);
 		}
 	#endif
 
 	if (g_scan_state_dir != SCAN_STATE_DIR_OFF || g_css_scan_mode == CSS_SCAN_MODE_SCANNING)
 		if (!g_monitor_enabled && g_current_function != FUNCTION_TRANSMIT)
-			DECREMENT(g_scan_tick_10ms);
-
-	DECREMENT_AND_TRIGGER(g_tail_tone_elimination_tick_10ms, g_flag_tail_tone_elimination_complete);
+			DECREMENT(g_scan_tick_10ms, ticks);
 
-	#ifdef ENABLE_VOICE
-		DECREMENT_AND_TRIGGER(g_play_next_voice_tick_10ms, g_flag_play_queued_voice);
-	#endif
-	
 	#ifdef ENABLE_FMRADIO
 		if (g_fm_scan_state_dir != FM_SCAN_STATE_DIR_OFF &&
 		   !g_monitor_enabled &&
 		    g_current_function != FUNCTION_TRANSMIT &&
 		    g_current_function != FUNCTION_RECEIVE)
 		{
-			DECREMENT_AND_TRIGGER(g_fm_play_tick_10ms, g_fm_schedule);
+			DECREMENT_AND_TRIGGER(g_fm_play_tick_10ms, ticks, g_fm_schedule);
 		}
 	#endif
+}
 
-	#ifdef ENABLE_VOX
-		DECREMENT(g_vox_stop_tick_10ms);
-	#endif
+void SCHEDULER_dispatch(void)
+{	// call the expired timers, catching up on any ticks we were too busy for
+
+	uint32_t now;
+
+	sched_pending = false;
+	now = g_global_sys_tick_counter;
+
+	SCHEDULER_countdowns(now - sched_dispatched_tick);
+
+	while (sched_dispatched_tick != now)
+	{
+		const uint32_t            tick = ++sched_dispatched_tick;
+		sched_timer_t * volatile *link = &sched_wheel[tick & (SCHED_WHEEL_SIZE - 1)];
+
+		while (*link != NULL)
+		{
+			sched_timer_t *timer = *link;
+
+			if (timer->expire_tick != tick)
+			{	// not this turn of the wheel
+				link = &timer->next;
+				continue;
+			}
+
+			*link       = timer->next;
+			timer->next = NULL;
+
+			if (timer->period_10ms > 0)
+			{	// periodic .. if we've fallen behind skip the missed ones rather than calling it back to back
+				uint32_t next = tick + timer->period_10ms;
+				if ((int32_t)(next - now) <= 0)
+				{
+					#ifdef ENABLE_SLICE_STATS
+						if (timer->stats != NULL)
+							timer->stats->missed += 1 + ((now - next) / timer->period_10ms);
+					#endif
+					next = now + 1;
+				}
+				SCHEDULER_insert(timer, next);
+			}
+
+			if (timer->callback == NULL)
+				continue;
+
+			#ifdef ENABLE_SLICE_STATS
+				if (timer->stats != NULL)
+				{
+					sched_stats_t *stats = timer->stats;   // the callback might restart the timer
+					const uint32_t start = SYSTICK_get_us();
+					timer->callback();
+					SCHEDULER_update_stats(stats, SYSTICK_get_us() - start, 10000);
+				}
+				else
+			#endif
+					timer->callback();
+
+			// the callback may have started/stopped timers in this slot
+			link = &sched_wheel[tick & (SCHED_WHEEL_SIZE - 1)];
+		}
+	}
+}
+
+void SystickHandler(void);
+
+// we come here every 10ms
+void SystickHandler(void)
+{
+	g_global_sys_tick_counter++;
 
-	DECREMENT(g_boot_tick_10ms);
+	if (sched_wheel[g_global_sys_tick_counter & (SCHED_WHEEL_SIZE - 1)] != NULL)
+		sched_pending = true;
 }
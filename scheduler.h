@@ -0,0 +1,65 @@
+/* Copyright 2023 One of Eleven
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef void (*sched_callback_t)(void);
+
+#ifdef ENABLE_SLICE_STATS
+	#define SCHED_STATS_BINS   8
+
+	// how long a timer's callback takes to run
+	typedef struct {
+		uint32_t count;                        // number of calls
+		uint32_t last_us;
+		uint32_t worst_us;
+		uint32_t overruns;                     // calls that took longer than they're allowed (the 10ms tick, the fast scan budget)
+		uint32_t missed;                       // periods skipped because we were too busy to call it
+		uint32_t histogram[SCHED_STATS_BINS];  // < 250us, < 500us, < 1ms, < 2ms, < 4ms, < 8ms, < 16ms, >= 16ms
+	} sched_stats_t;
+
+	// 0 = 10ms time slice, 1 = 500ms time slice, 2 = fast frequency scan busy waits
+	extern sched_stats_t g_time_slice_stats[3];
+#endif
+
+// owned by whoever starts it, usually a static in the module using it
+typedef struct sched_timer_t
+{
+	struct sched_timer_t *next;
+	uint32_t              expire_tick;   // systick count it's due on
+	uint16_t              period_10ms;   // 0 = one-shot
+	sched_callback_t      callback;      // called from the main loop, not the interrupt .. NULL = nothing to call, it just runs out
+	#ifdef ENABLE_SLICE_STATS
+		sched_stats_t    *stats;         // NULL = don't time it
+	#endif
+} sched_timer_t;
+
+void     SCHEDULER_start(sched_timer_t *timer, const uint32_t delay_10ms, const uint16_t period_10ms, sched_callback_t callback);
+void     SCHEDULER_stop(sched_timer_t *timer);
+bool     SCHEDULER_running(const sched_timer_t *timer);
+uint32_t SCHEDULER_remaining(const sched_timer_t *timer);
+uint32_t SCHEDULER_ticks(void);
+bool     SCHEDULER_pending(void);
+void     SCHEDULER_dispatch(void);
+#ifdef ENABLE_SLICE_STATS
+	void SCHEDULER_update_stats(sched_stats_t *stats, const uint32_t time_us, const uint32_t limit_us);
+#endif
+
+#endif
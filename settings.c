@@ -21,11 +21,17 @@
 #endif
 #include "driver/bk4819.h"
 #include "driver/eeprom.h"
+#ifdef ENABLE_SLICE_STATS
+	#include "driver/systick.h"
+#endif
 #if defined(ENABLE_UART) && defined(ENABLE_UART_DEBUG)
 	#include "driver/uart.h"
 #endif
 #include "misc.h"
 #include "radio.h"
+#ifdef ENABLE_EEPROM_CACHE
+	#include "scheduler.h"
+#endif
 #include "settings.h"
 #include "ui/menu.h"
 
@@ -43,36 +49,533 @@ static const uint32_t DEFAULT_FREQUENCY_TABLE[] =
 
 t_eeprom g_eeprom;
 
+#ifdef ENABLE_EEPROM_CACHE
+	// changes to g_eeprom are saved lazily a block at a time ..
+	//
+	// a change marks its 8-byte blocks as dirty, and the dirty blocks are written out once
+	// nothing else has changed for a while, or after a maximum delay if changes keep on coming
+	//
+	// only blocks that are known to have changed are marked, so they're written without
+	// reading the eeprom back first .. the settings area is edited in place all over the
+	// place, so a copy of what's in the eeprom is kept to see which of its blocks have changed
+
+	#define SETTINGS_FLUSH_IDLE_10ms    (500 / 10)    // write once nothing has changed for 500ms
+	#define SETTINGS_FLUSH_LIMIT_10ms   (2000 / 10)   // but don't sit on a change for more than 2 seconds
+
+	static uint8_t       settings_dirty[sizeof(g_eeprom) / 8 / 8];          // a bit per 8-byte block
+	static bool          settings_dirty_any;
+	static uint32_t      settings_dirty_tick;                               // when the oldest unsaved change was made
+	static uint8_t       settings_saved[sizeof(g_eeprom.config.setting)];   // what's in the eeprom
+	static sched_timer_t settings_flush_timer;
+
+	static bool SETTINGS_is_dirty(const unsigned int block)
+	{
+		return (settings_dirty[block / 8] & (1u << (block % 8))) != 0;
+	}
+
+	static unsigned int SETTINGS_setting_index(void)
+	{
+		return (unsigned int)(((uint8_t *)&g_eeprom.config.setting) - ((uint8_t *)&g_eeprom));
+	}
+#endif
+
+#ifdef ENABLE_VFO_JOURNAL
+	// the VFO frequencies, the VFO channel indices and the FM frequency change every time the
+	// radio is tuned, so rather than wearing out their own eeprom bytes, their changes are saved
+	// as records appended to a small journal in the otherwise unused pages at 0x1BE0 and 0x1FA0
+	//
+	// the eeprom wears a whole 32-byte page per write, so each record has a page of its own,
+	// that way each of the 4 pages (and the normal place) only take 1 in 4 of the writes
+	//
+	// each record holds the address and new value of one of those 4-byte words, on boot the
+	// records are replayed (oldest first) on top of the values in their normal place
+	//
+	// each time the journal wraps round, the latest values are first written back to their
+	// normal place, so none of the records about to be overwritten are needed any more
+	//
+	// like everything else, changes are only saved when the cache is flushed, so a burst of
+	// tuning only costs the one record
+
+	#define JOURNAL_WORDS     (14 + 2 + 1)    // VFO channel frequencies, VFO channel indices, FM frequency
+	#define JOURNAL_RECORDS   (1 + ARRAY_SIZE(g_eeprom.calib.vfo_journal_b))
+
+	static uint32_t     journal_home[JOURNAL_WORDS];    // what's in their normal place
+	static uint32_t     journal_value[JOURNAL_WORDS];   // latest saved values
+	static uint32_t     journal_pending[JOURNAL_WORDS]; // changes waiting for the next flush
+	static uint32_t     journal_pending_mask;           // a bit per word
+	static unsigned int journal_slot;                   // next record to write
+	static uint8_t      journal_seq;                    // and its sequence number
+	static bool         journal_enabled;                // false = save them in their normal place (until the next boot)
+
+	static unsigned int JOURNAL_address(const unsigned int word)
+	{
+		if (word < 14)
+			return (unsigned int)(((uint8_t *)&g_eeprom.config.vfo_channel[word].frequency) - ((uint8_t *)&g_eeprom));
+		if (word < 16)
+			return (unsigned int)(((uint8_t *)&g_eeprom.config.setting.indices) - ((uint8_t *)&g_eeprom)) + ((word - 14) * 4);
+		return (unsigned int)(((uint8_t *)&g_eeprom.config.setting.fm_radio) - ((uint8_t *)&g_eeprom));
+	}
+
+	static int JOURNAL_word(const unsigned int index)
+	{	// which journalled word the eeprom byte is in, -1 if none
+		const unsigned int vfo_channel = JOURNAL_address(0);
+		const unsigned int indices     = JOURNAL_address(14);
+		const unsigned int fm_radio    = JOURNAL_address(16);
+
+		if (index >= vfo_channel && index < (vfo_channel + (14 * sizeof(t_channel))) && ((index - vfo_channel) % sizeof(t_channel)) < 4)
+			return (index - vfo_channel) / sizeof(t_channel);
+		if (index >= indices && index < (indices + 8))
+			return 14 + ((index - indices) / 4);
+		if (index >= fm_radio && index < (fm_radio + 4))
+			return 16;
+		return -1;
+	}
+
+	static t_journal_record * JOURNAL_record(const unsigned int slot)
+	{
+		return (slot == 0) ? &g_eeprom.config.vfo_journal_a.record : &g_eeprom.calib.vfo_journal_b[slot - 1].record;
+	}
+
+	static uint32_t JOURNAL_get(const unsigned int word)
+	{
+		uint32_t value;
+		memcpy(&value, ((uint8_t *)&g_eeprom) + JOURNAL_address(word), sizeof(value));
+		return value;
+	}
+
+	static uint8_t JOURNAL_check(const t_journal_record *record)
+	{
+		const uint8_t *p   = (const uint8_t *)record;
+		uint8_t        sum = 0;
+		unsigned int   i;
+
+		for (i = 0; i < sizeof(*record); i++)
+			if (i != 1)
+				sum += p[i];
+
+		return ~sum;
+	}
+
+	static void JOURNAL_write_back(void)
+	{	// save the latest values in their normal place
+		const unsigned int setting = SETTINGS_setting_index();
+		unsigned int       word;
+
+		for (word = 0; word < JOURNAL_WORDS; word++)
+		{
+			const unsigned int index = JOURNAL_address(word);
+
+			if (journal_value[word] == journal_home[word])
+				continue;
+
+			EEPROM_WriteBufferChanged(index, &journal_value[word], 4);
+			journal_home[word] = journal_value[word];
+
+			if (index >= setting && index < (setting + sizeof(settings_saved)))
+				memcpy(&settings_saved[index - setting], &journal_value[word], 4);
+		}
+	}
+
+	static void JOURNAL_save(const unsigned int word, const uint32_t value)
+	{	// append a record if the value has changed
+		t_journal_record  *record = JOURNAL_record(journal_slot);
+		const unsigned int index  = (unsigned int)(((uint8_t *)record) - ((uint8_t *)&g_eeprom));
+
+		if (value == journal_value[word])
+			return;
+
+		if (journal_slot == 0)
+			JOURNAL_write_back();   // going round again
+
+		journal_value[word] = value;
+
+		record->seq     = journal_seq++;
+		record->address = JOURNAL_address(word);
+		record->value   = value;
+		record->check   = JOURNAL_check(record);
+		EEPROM_WriteBufferChanged(index, record, sizeof(*record));
+
+		journal_slot = (journal_slot + 1) % JOURNAL_RECORDS;
+	}
+
+	static bool JOURNAL_change(const unsigned int word, const uint32_t value)
+	{	// returns true if it's a new value
+		const uint32_t bit = 1u << word;
+		if (value == ((journal_pending_mask & bit) ? journal_pending[word] : journal_value[word]))
+			return false;
+		journal_pending[word] = value;
+		journal_pending_mask |= bit;
+		return true;
+	}
+
+	static void JOURNAL_save_pending(void)
+	{
+		unsigned int word;
+		for (word = 0; word < JOURNAL_WORDS; word++)
+			if (journal_pending_mask & (1u << word))
+				JOURNAL_save(word, journal_pending[word]);
+		journal_pending_mask = 0;
+	}
+
+	static bool JOURNAL_covers(const unsigned int index, const unsigned int size, const unsigned int i)
+	{	// true if byte 'i' of the range is in a journalled word that's entirely inside the range
+		const int word = JOURNAL_word(index + i);
+		if (!journal_enabled || word < 0)
+			return false;
+		return JOURNAL_address(word) >= index && (JOURNAL_address(word) + 4) <= (index + size);
+	}
+
+	static void JOURNAL_load(void)
+	{	// replay the journal on top of the values read from the eeprom
+		int          newest = -1;
+		unsigned int word;
+		unsigned int i;
+
+		for (word = 0; word < JOURNAL_WORDS; word++)
+		{
+			journal_home[word]  = JOURNAL_get(word);
+			journal_value[word] = journal_home[word];
+		}
+
+		for (i = 0; i < JOURNAL_RECORDS; i++)
+		{
+			const t_journal_record *record = JOURNAL_record(i);
+			if (record->check != JOURNAL_check(record))
+				continue;
+			if (newest < 0 || (int8_t)(record->seq - JOURNAL_record(newest)->seq) > 0)
+				newest = i;
+		}
+
+		journal_slot    = 0;
+		journal_seq     = 0;
+		journal_enabled = true;
+
+		if (newest < 0)
+			return;   // empty
+
+		for (i = 1; i <= JOURNAL_RECORDS; i++)
+		{	// oldest first
+			const t_journal_record *record = JOURNAL_record((newest + i) % JOURNAL_RECORDS);
+			const int               word   = JOURNAL_word(record->address);
+
+			if (record->check != JOURNAL_check(record) || word < 0 || JOURNAL_address(word) != record->address)
+				continue;
+
+			journal_value[word] = record->value;
+			memcpy(((uint8_t *)&g_eeprom) + record->address, &record->value, 4);
+		}
+
+		journal_slot = (newest + 1) % JOURNAL_RECORDS;
+		journal_seq  = JOURNAL_record(newest)->seq + 1;
+	}
+
+	void SETTINGS_stop_journal(void)
+	{	// put everything back in its normal place and empty the journal, so anything reading
+		// or writing the raw eeprom (PC, aircopy, reset) doesn't need to know about it
+		unsigned int word;
+		unsigned int slot;
+
+		if (!journal_enabled)
+			return;
+
+		journal_enabled = false;
+
+		for (word = 0; word < JOURNAL_WORDS; word++)
+			if (journal_pending_mask & (1u << word))
+				journal_value[word] = journal_pending[word];
+		journal_pending_mask = 0;
+
+		JOURNAL_write_back();
+
+		for (slot = 0; slot < JOURNAL_RECORDS; slot++)
+		{
+			t_journal_record  *record = JOURNAL_record(slot);
+			const unsigned int index  = (unsigned int)(((uint8_t *)record) - ((uint8_t *)&g_eeprom));
+
+			memset(record, 0xff, sizeof(*record));
+			EEPROM_WriteBuffer(index, record, sizeof(*record));
+		}
+	}
+#endif
+
+#ifdef ENABLE_EEPROM_CACHE
+
+	static void SETTINGS_mark_changed(const unsigned int index, const uint8_t *p_old, const uint8_t *p_new, const unsigned int size)
+	{	// mark the blocks that differ as dirty, and (re)start the flush timer
+		const uint32_t now     = SCHEDULER_ticks();
+		bool           changed = false;
+		uint32_t       waited;
+		uint32_t       delay;
+		unsigned int   i;
+
+		for (i = 0; i < size; i++)
+		{
+			#ifdef ENABLE_VFO_JOURNAL
+				if (JOURNAL_covers(index, size, i))
+				{	// goes in the journal instead
+					if ((JOURNAL_address(JOURNAL_word(index + i)) - index) == i)
+					{
+						uint32_t value;
+						memcpy(&value, &p_new[i], sizeof(value));
+						if (JOURNAL_change(JOURNAL_word(index + i), value))
+							changed = true;
+					}
+					continue;
+				}
+			#endif
+
+			if (p_old[i] != p_new[i])
+			{
+				const unsigned int block = (index + i) / 8;
+				settings_dirty[block / 8] |= 1u << (block % 8);
+				changed = true;
+			}
+		}
+
+		if (!changed)
+			return;
+
+		if (!settings_dirty_any)
+		{
+			settings_dirty_any  = true;
+			settings_dirty_tick = now;
+		}
+
+		waited = now - settings_dirty_tick;
+		delay  = SETTINGS_FLUSH_IDLE_10ms;
+		if ((waited + delay) > SETTINGS_FLUSH_LIMIT_10ms)
+			delay = (waited < SETTINGS_FLUSH_LIMIT_10ms) ? SETTINGS_FLUSH_LIMIT_10ms - waited : 1;
+
+		SCHEDULER_start(&settings_flush_timer, delay, 0, SETTINGS_flush);
+	}
+
+	void SETTINGS_flush(void)
+	{	// write the dirty blocks out now, joining neighbouring ones into single writes
+
+		const unsigned int setting = SETTINGS_setting_index();
+		unsigned int       block   = 0;
+
+		SCHEDULER_stop(&settings_flush_timer);
+
+		if (!settings_dirty_any)
+			return;
+
+		#ifdef ENABLE_VFO_JOURNAL
+			JOURNAL_save_pending();
+		#endif
+
+		while (block < (sizeof(g_eeprom) / 8))
+		{
+			unsigned int first;
+			unsigned int index;
+			unsigned int size;
+
+			if (settings_dirty[block / 8] == 0)
+			{	// skip the clean ones 8 at a time
+				block += 8;
+				continue;
+			}
+
+			if (!SETTINGS_is_dirty(block))
+			{
+				block++;
+				continue;
+			}
+
+			first = block;
+			while (block < (sizeof(g_eeprom) / 8) && SETTINGS_is_dirty(block))
+			{
+				settings_dirty[block / 8] &= ~(1u << (block % 8));
+				block++;
+			}
+
+			index = first * 8;
+			size  = (block - first) * 8;
+
+			EEPROM_WriteBufferChanged(index, ((uint8_t *)&g_eeprom) + index, size);
+
+			#ifdef ENABLE_VFO_JOURNAL
+			{	// any journalled words written along with the rest are now in their normal place
+				unsigned int i;
+				for (i = 0; i < size; i++)
+				{
+					const int word = JOURNAL_word(index + i);
+					if (word >= 0 && JOURNAL_address(word) == (index + i))
+						journal_home[word] = JOURNAL_get(word);
+				}
+			}
+			#endif
+
+			// keep the copy of the settings area up to date
+			if (index < (setting + sizeof(settings_saved)) && (index + size) > setting)
+			{
+				const unsigned int start = (index > setting) ? index : setting;
+				const unsigned int end   = ((index + size) < (setting + sizeof(settings_saved))) ? index + size : setting + sizeof(settings_saved);
+				memcpy(&settings_saved[start - setting], ((uint8_t *)&g_eeprom) + start, end - start);
+			}
+		}
+
+		settings_dirty_any = false;
+	}
+#endif
+
+static void SETTINGS_check_channel(const unsigned int index)
+{	// channel sanity checks ..
+	t_channel *channel = &g_eeprom.config.channel[index];
+
+	if (channel->mod_mode >= MOD_MODE_LEN)
+		channel->mod_mode = MOD_MODE_FM;
+
+	if (channel->tx_power_user == 0)
+		channel->tx_power_user = 8;
+
+	if (channel->squelch_level > 9)
+		channel->squelch_level = 0;
+
+	if (index > USER_CHANNEL_LAST)
+		return;
+
+	// .. and cleaning
+	if (g_eeprom.config.channel_attributes[index].band > BAND7_470MHz)
+	{	// unused channel
+		memset(channel, 0xff, sizeof(*channel));
+	}
+	else
+	if (channel->frequency > 0 && channel->frequency < 0xffffffff)
+	{	// ensure the channel band attribute is correct
+		g_eeprom.config.channel_attributes[index].band = FREQUENCY_GetBand(channel->frequency);
+	}
+}
+
+static void SETTINGS_check_channel_name(const unsigned int index)
+{
+	if (g_eeprom.config.channel_attributes[index].band > BAND7_470MHz)
+		memset(&g_eeprom.config.channel_name[index], 0xff, sizeof(g_eeprom.config.channel_name[index]));   // unused channel
+	else
+		memset(g_eeprom.config.channel_name[index].unused, 0x00, sizeof(g_eeprom.config.channel_name[index].unused));
+}
+
+static void SETTINGS_check_records(const unsigned int index, const unsigned int size)
+{	// check the channels and channel names that are in that part of g_eeprom
+	const unsigned int names = (unsigned int)(((uint8_t *)&g_eeprom.config.channel_name) - ((uint8_t *)&g_eeprom));
+	unsigned int       i;
+
+	// both are 16-byte records on 16-byte boundaries
+	for (i = index & ~15u; i < (index + size); i += 16)
+	{
+		if (i < sizeof(g_eeprom.config.channel))
+			SETTINGS_check_channel(i / sizeof(t_channel));
+		else
+		if (i >= names && i < (names + sizeof(g_eeprom.config.channel_name)))
+			SETTINGS_check_channel_name((i - names) / sizeof(t_channel_name));
+	}
+}
+
+#ifdef ENABLE_EEPROM_LAZY_LOAD
+	// only what's needed to get the radio going is read in at boot (the VFO channels, channel
+	// attributes, settings, journal and calibration), the rest (the user channels and their names,
+	// the DTMF contacts and the scan ignore list) then follows a block at a time in the background
+	//
+	// anything wanting a part that's not arrived yet reads it in there and then
+
+	#define SETTINGS_LOAD_BLOCK    64
+	#define SETTINGS_LOAD_BLOCKS   (sizeof(g_eeprom) / SETTINGS_LOAD_BLOCK)
+
+	static uint8_t      settings_resident[SETTINGS_LOAD_BLOCKS / 8];   // a bit per block that's been read in
+	static unsigned int settings_load_block;                           // where the background load has got to
+
+	static bool SETTINGS_is_resident(const unsigned int block)
+	{
+		return (settings_resident[block / 8] & (1u << (block % 8))) != 0;
+	}
+
+	void SETTINGS_load(const unsigned int index, const unsigned int size)
+	{	// make sure that part of g_eeprom has been read in
+		unsigned int block;
+
+		for (block = index / SETTINGS_LOAD_BLOCK; block < ((index + size + SETTINGS_LOAD_BLOCK - 1) / SETTINGS_LOAD_BLOCK) && block < SETTINGS_LOAD_BLOCKS; block++)
+		{
+			const unsigned int address = block * SETTINGS_LOAD_BLOCK;
+
+			if (SETTINGS_is_resident(block))
+				continue;
+
+			EEPROM_ReadBuffer(address, ((uint8_t *)&g_eeprom) + address, SETTINGS_LOAD_BLOCK);
+			settings_resident[block / 8] |= 1u << (block % 8);
+
+			SETTINGS_check_records(address, SETTINGS_LOAD_BLOCK);
+		}
+	}
+
+	void SETTINGS_load_channel(const unsigned int channel)
+	{	// make sure a user channel and its name have been read in
+		if (channel > USER_CHANNEL_LAST)
+			return;
+		SETTINGS_load((unsigned int)(((uint8_t *)&g_eeprom.config.channel[channel])      - ((uint8_t *)&g_eeprom)), sizeof(t_channel));
+		SETTINGS_load((unsigned int)(((uint8_t *)&g_eeprom.config.channel_name[channel]) - ((uint8_t *)&g_eeprom)), sizeof(t_channel_name));
+	}
+#endif
+
+static void SETTINGS_write(const unsigned int index, const unsigned int size)
+{	// save part of g_eeprom
+	#ifdef ENABLE_EEPROM_LAZY_LOAD
+		SETTINGS_load(index, size);
+	#endif
+
+	#ifdef ENABLE_EEPROM_CACHE
+		const unsigned int setting = SETTINGS_setting_index();
+		if (index >= setting && (index + size) <= (setting + sizeof(settings_saved)))
+		{	// we know what's in the eeprom, so no need to read it back to see what's changed
+			SETTINGS_mark_changed(index, &settings_saved[index - setting], ((uint8_t *)&g_eeprom) + index, size);
+			return;
+		}
+	#endif
+
+	EEPROM_WriteBuffer(index, ((uint8_t *)&g_eeprom) + index, size);
+}
+
+static void SETTINGS_update(void *p_eeprom, const void *p_data, const unsigned int size)
+{	// copy new data into g_eeprom and save whatever it changes
+	const unsigned int index = (unsigned int)(((uint8_t *)p_eeprom) - ((uint8_t *)&g_eeprom));
+
+	#ifdef ENABLE_EEPROM_LAZY_LOAD
+		SETTINGS_load(index, size);
+	#endif
+
+	#ifdef ENABLE_EEPROM_CACHE
+		SETTINGS_mark_changed(index, p_eeprom, p_data, size);
+		memmove(p_eeprom, p_data, size);
+	#else
+		memmove(p_eeprom, p_data, size);
+		EEPROM_WriteBuffer(index, p_eeprom, size);
+	#endif
+}
+
 void SETTINGS_write_eeprom_config(void)
 {	// save the entire EEPROM config contents
-	unsigned int index;
-	for (index = 0; index < sizeof(g_eeprom.config); index += 8)
-		EEPROM_WriteBuffer8(index, ((uint8_t *)&g_eeprom) + index);
+	#ifdef ENABLE_EEPROM_LAZY_LOAD
+		SETTINGS_load(0, sizeof(g_eeprom.config));
+	#endif
+	EEPROM_WriteBuffer(0, &g_eeprom.config, sizeof(g_eeprom.config));
 }
 
 void SETTINGS_write_eeprom_calib(void)
 {	// save the entire EEPROM calibration contents
-	unsigned int i;
-	unsigned int index = (unsigned int)(((uint8_t *)&g_eeprom.calib) - ((uint8_t *)&g_eeprom));
-	index &= ~7u;
-	for (i = 0; i < sizeof(g_eeprom.calib); i += 8)
-		EEPROM_WriteBuffer8(index + i, ((uint8_t *)&g_eeprom) + index + i);
+	const unsigned int index = (unsigned int)(((uint8_t *)&g_eeprom.calib) - ((uint8_t *)&g_eeprom));
+	SETTINGS_write(index, sizeof(g_eeprom.calib));
 }
 
 #ifdef ENABLE_FMRADIO
 	void SETTINGS_save_fm(void)
 	{
-		unsigned int i;
 		unsigned int index;
 
 		index = (unsigned int)(((uint8_t *)&g_eeprom.config.setting.fm_radio) - ((uint8_t *)&g_eeprom));
 		index &= ~7u;
-		EEPROM_WriteBuffer8(index, ((uint8_t *)&g_eeprom) + index);
+		SETTINGS_write(index, 8);
 
 		index = (unsigned int)(((uint8_t *)&g_eeprom.config.setting.fm_channel) - ((uint8_t *)&g_eeprom));
-		index &= ~7u;
-		for (i = 0; i < sizeof(g_eeprom.config.setting.fm_channel); i += 8)
-			EEPROM_WriteBuffer8(index + i, ((uint8_t *)&g_eeprom) + index + i);
+		SETTINGS_write(index, sizeof(g_eeprom.config.setting.fm_channel));
 	}
 #endif
 
@@ -80,65 +583,107 @@ void SETTINGS_save_vfo_indices(void)
 {
 	uint16_t index = (uint16_t)(((uint8_t *)&g_eeprom.config.setting.indices) - ((uint8_t *)&g_eeprom));
 	index &= ~7u;
-	EEPROM_WriteBuffer8(index, ((uint8_t *)&g_eeprom) + index);
+	SETTINGS_write(index, 8);
 }
 
 void SETTINGS_save_attributes(void)
 {
-	unsigned int i;
-	unsigned int index = (unsigned int)(((uint8_t *)&g_eeprom.config.channel_attributes) - ((uint8_t *)&g_eeprom));
-	index &= ~7u;
-	for (i = 0; i < sizeof(g_eeprom.config.channel_attributes); i += 8)
-		EEPROM_WriteBuffer8(index + i, ((uint8_t *)&g_eeprom) + index + i);
+	const unsigned int index = (unsigned int)(((uint8_t *)&g_eeprom.config.channel_attributes) - ((uint8_t *)&g_eeprom));
+	SETTINGS_write(index, sizeof(g_eeprom.config.channel_attributes));
 }
 
 void SETTINGS_save_channel_names(void)
 {
-	unsigned int i;
-	unsigned int index = (unsigned int)(((uint8_t *)&g_eeprom.config.channel_name) - ((uint8_t *)&g_eeprom));
-	index &= ~7u;
-	for (i = 0; i < sizeof(g_eeprom.config.channel_name); i += 8)
-		EEPROM_WriteBuffer8(index + i, ((uint8_t *)&g_eeprom) + index + i);
+	const unsigned int index = (unsigned int)(((uint8_t *)&g_eeprom.config.channel_name) - ((uint8_t *)&g_eeprom));
+	SETTINGS_write(index, sizeof(g_eeprom.config.channel_name));
 }
 
+#ifdef ENABLE_EEPROM_LAZY_LOAD
+	static void SETTINGS_loaded(void)
+	{	// everything's been read in
+		unsigned int vfo;
+
+		// any channel band attributes put right as the channels arrived
+		SETTINGS_save_attributes();
+
+		// the VFO frequencies might be in one of the channels that's just arrived
+		for (vfo = 0; vfo < ARRAY_SIZE(g_vfo_info); vfo++)
+			if (IS_FREQ_CHANNEL(g_vfo_info[vfo].channel_save))
+				g_vfo_info[vfo].freq_in_channel = SETTINGS_find_channel(g_vfo_info[vfo].freq_config_rx.frequency);
+
+		g_update_display = true;
+
+		#ifdef ENABLE_SLICE_STATS
+			if (g_boot_loaded_us == 0)
+				g_boot_loaded_us = SYSTICK_get_us();
+		#endif
+	}
+
+	void SETTINGS_load_next(void)
+	{	// called every 10ms (and while the boot screen is up) .. read in the next block that's still missing
+		while (settings_load_block < SETTINGS_LOAD_BLOCKS)
+		{
+			const unsigned int block = settings_load_block++;
+			if (!SETTINGS_is_resident(block))
+			{
+				SETTINGS_load(block * SETTINGS_LOAD_BLOCK, SETTINGS_LOAD_BLOCK);
+				return;
+			}
+		}
+
+		if (settings_load_block == SETTINGS_LOAD_BLOCKS)
+		{	// that's the lot
+			settings_load_block++;
+			SETTINGS_loaded();
+		}
+	}
+#endif
+
 void SETTINGS_read_eeprom(void)
 {
 	unsigned int index;
 
-	// read the entire EEPROM contents into memory
-	for (index = 0; index < sizeof(g_eeprom); index += 128)
-		EEPROM_ReadBuffer(index, (uint8_t *)(&g_eeprom) + index, 128);
+	#ifdef ENABLE_EEPROM_LAZY_LOAD
+	{	// read in just what's needed to get going, SETTINGS_load_next() brings in the rest
+		const unsigned int vfo_channel = (unsigned int)(((uint8_t *)&g_eeprom.config.vfo_channel)   - ((uint8_t *)&g_eeprom));
+		const unsigned int names       = (unsigned int)(((uint8_t *)&g_eeprom.config.channel_name)  - ((uint8_t *)&g_eeprom));
+		const unsigned int journal     = (unsigned int)(((uint8_t *)&g_eeprom.config.vfo_journal_a) - ((uint8_t *)&g_eeprom));
+		const unsigned int calib       = (unsigned int)(((uint8_t *)&g_eeprom.calib)               - ((uint8_t *)&g_eeprom));
+
+		memset(settings_resident, 0, sizeof(settings_resident));
+		settings_load_block = 0;
+
+		SETTINGS_load(vfo_channel, names - vfo_channel);   // VFO channels, channel attributes and settings
+		SETTINGS_load(journal, sizeof(g_eeprom.config.vfo_journal_a));
+		SETTINGS_load(calib, sizeof(g_eeprom.calib));
+	}
+	#else
+		// read the entire EEPROM contents into memory
+		for (index = 0; index < sizeof(g_eeprom); index += 128)
+			EEPROM_ReadBuffer(index, (uint8_t *)(&g_eeprom) + index, 128);
+	#endif
+
+	#ifdef ENABLE_EEPROM_CACHE
+		memcpy(settings_saved, &g_eeprom.config.setting, sizeof(settings_saved));
+	#endif
+	#ifdef ENABLE_VFO_JOURNAL
+		JOURNAL_load();
+	#endif
 
 	#if defined(ENABLE_UART) && defined(ENABLE_UART_DEBUG)
 		UART_printf("config size %04X %u\r\n"
-		            "unused size %04X %u\r\n"
+		            "ignore size %04X %u\r\n"
 		            "calib  size %04X %u\r\n"
 		            "eeprom size %04X %u\r\n",
-		             sizeof(g_eeprom.config), sizeof(g_eeprom.config),
-					 sizeof(g_eeprom.unused), sizeof(g_eeprom.unused),
-					 sizeof(g_eeprom.calib),  sizeof(g_eeprom.calib),
-					 sizeof(g_eeprom),        sizeof(g_eeprom));
+		             sizeof(g_eeprom.config),      sizeof(g_eeprom.config),
+					 sizeof(g_eeprom.scan_ignore), sizeof(g_eeprom.scan_ignore),
+					 sizeof(g_eeprom.calib),       sizeof(g_eeprom.calib),
+					 sizeof(g_eeprom),             sizeof(g_eeprom));
 	#endif
 
-#if 1
-	// channel sanity checks ..
-
-	for (index = 0; index < ARRAY_SIZE(g_eeprom.config.channel); index++)
-	{
-//		if (g_eeprom.config.channel_attributes[index].band <= BAND7_470MHz)
-		{	// used channel
-
-			if (g_eeprom.config.channel[index].mod_mode >= MOD_MODE_LEN)
-				g_eeprom.config.channel[index].mod_mode = MOD_MODE_FM;
-
-			if (g_eeprom.config.channel[index].tx_power_user == 0)
-				g_eeprom.config.channel[index].tx_power_user = 8;
-
-			if (g_eeprom.config.channel[index].squelch_level > 9)
-				g_eeprom.config.channel[index].squelch_level = 0;
-
-		}
-	}
+#ifndef ENABLE_EEPROM_LAZY_LOAD
+	// channel sanity checks and cleaning (done as they're read in otherwise)
+	SETTINGS_check_records(0, sizeof(g_eeprom));
 #endif
 
 #if 0
@@ -363,28 +908,25 @@ void SETTINGS_read_eeprom(void)
 	// EEPROM cleaning
 
 #if 1
-	memset(&g_eeprom.config.unused13, 0xff, sizeof(g_eeprom.config.unused13));
+	#ifndef ENABLE_VFO_JOURNAL
+		memset(&g_eeprom.config.vfo_journal_a, 0xff, sizeof(g_eeprom.config.vfo_journal_a));
+		memset(&g_eeprom.calib.vfo_journal_b,  0xff, sizeof(g_eeprom.calib.vfo_journal_b));
+	#endif
 
-	memset(&g_eeprom.unused, 0xff, sizeof(g_eeprom.unused));
+	#ifndef ENABLE_SCAN_IGNORE_LIST
+		#ifdef ENABLE_EEPROM_LAZY_LOAD
+			SETTINGS_load((unsigned int)(g_eeprom.scan_ignore - (uint8_t *)&g_eeprom), sizeof(g_eeprom.scan_ignore));   // so it's not read in over the top later
+		#endif
+		memset(&g_eeprom.scan_ignore, 0xff, sizeof(g_eeprom.scan_ignore));
+	#endif
 
-	// clear out unused channels
+	// clear out unused channel attributes (their channels and names are cleared by SETTINGS_check_records())
 	for (index = 0; index < 200; index++)
 	{
 		if (g_eeprom.config.channel_attributes[index].band > BAND7_470MHz)
-		{	// unused channel
-			g_eeprom.config.channel_attributes[index].attributes = 0xff;
-			memset(&g_eeprom.config.user_channel[index], 0xff, sizeof(g_eeprom.config.user_channel[index]));
-			memset(&g_eeprom.config.channel_name[index], 0xff, sizeof(g_eeprom.config.channel_name[index]));
-		}
+			g_eeprom.config.channel_attributes[index].attributes = 0xff;   // unused channel
 		else
-		{	// used channel
-			g_eeprom.config.channel_attributes[index].unused = 0x00;
-			memset(g_eeprom.config.channel_name[index].unused, 0x00, sizeof(g_eeprom.config.channel_name[index].unused));
-
-			// ensure the channel band attribute is correct
-			if (g_eeprom.config.channel[index].frequency > 0 && g_eeprom.config.channel[index].frequency < 0xffffffff)
-				g_eeprom.config.channel_attributes[index].band = FREQUENCY_GetBand(g_eeprom.config.channel[index].frequency);
-		}
+			g_eeprom.config.channel_attributes[index].unused = 0x00;       // used channel
 	}
 
 	// force default VFO attributes
@@ -395,6 +937,8 @@ void SETTINGS_read_eeprom(void)
 	SETTINGS_save_attributes();
 #endif
 
+	RADIO_build_channel_bitmaps();
+
 	// ****************************************
 	// eeprom calibration data
 
@@ -425,12 +969,25 @@ void SETTINGS_read_eeprom(void)
 //	BK4819_write_reg(0x3C, g_eeprom.calib.BK4819_XTAL_FREQ_HIGH);
 
 	// ****************************************
+
+	#ifdef ENABLE_EEPROM_LAZY_LOAD
+		// and the channels the VFO's are sat on
+		for (index = 0; index < ARRAY_SIZE(g_eeprom.config.setting.indices.vfo); index++)
+			SETTINGS_load_channel(g_eeprom.config.setting.indices.vfo[index].screen);
+	#elif defined(ENABLE_SLICE_STATS)
+		if (g_boot_loaded_us == 0)
+			g_boot_loaded_us = SYSTICK_get_us();
+	#endif
 }
 
 void SETTINGS_save(void)
 {
 	uint32_t index;
 
+	#if defined(ENABLE_SCAN_REG_IMAGES) || defined(ENABLE_VFO_REG_IMAGES)
+		RADIO_invalidate_images();
+	#endif
+
 	#ifndef ENABLE_KEYLOCK
 		g_eeprom.config.setting.key_lock = 0;
 	#endif
@@ -465,11 +1022,8 @@ void SETTINGS_save(void)
 		g_eeprom.config.setting.radio_disabled = 0;
 	#endif
 
-	for (index = 0; index < sizeof(g_eeprom.config.setting); index += 8)
-	{
-		const uint16_t offset = (uint16_t)(((uint8_t *)&g_eeprom.config.setting) - ((uint8_t *)&g_eeprom));
-		EEPROM_WriteBuffer8(offset + index, ((uint8_t *)&g_eeprom) + offset + index);
-	}
+	index = (uint32_t)(((uint8_t *)&g_eeprom.config.setting) - ((uint8_t *)&g_eeprom));
+	SETTINGS_write(index, sizeof(g_eeprom.config.setting));
 }
 
 void SETTINGS_save_channel(const unsigned int channel, const unsigned int vfo, vfo_info_t *p_vfo, const unsigned int mode)
@@ -477,6 +1031,10 @@ void SETTINGS_save_channel(const unsigned int channel, const unsigned int vfo, v
 	if (!IS_USER_CHANNEL(channel) && !IS_FREQ_CHANNEL(channel))
 		return;
 
+	#if defined(ENABLE_SCAN_REG_IMAGES) || defined(ENABLE_VFO_REG_IMAGES)
+		RADIO_invalidate_images();
+	#endif
+
 	if (p_vfo != NULL)
 	{
 		p_vfo->channel.frequency           = p_vfo->freq_config_rx.frequency;
@@ -496,7 +1054,6 @@ void SETTINGS_save_channel(const unsigned int channel, const unsigned int vfo, v
 	{	// save the channel to EEPROM
 
 		const unsigned int chan = CHANNEL_NUM(channel, vfo);
-		const unsigned int addr = sizeof(t_channel) * chan;
 		t_channel          m_channel;
 
 		if (p_vfo != NULL)
@@ -509,15 +1066,7 @@ void SETTINGS_save_channel(const unsigned int channel, const unsigned int vfo, v
 //			UART_printf("save chan 2 %04X  %3u %3u %u %u %uHz %uHz\r\n", addr, chan, channel, vfo, mode, m_channel.frequency * 10, m_channel.tx_offset * 10);
 		#endif
 
-		memcpy(&g_eeprom.config.channel[chan], &m_channel, sizeof(t_channel));
-
-		g_eeprom.config.channel_attributes[channel] = p_vfo->channel_attributes;
-
-		memset(&g_eeprom.config.channel_name[channel], 0, sizeof(g_eeprom.config.channel_name[channel]));
-		memcpy(g_eeprom.config.channel_name[channel].name, p_vfo->channel_name.name, sizeof(g_eeprom.config.channel_name[channel].name));
-
-		EEPROM_WriteBuffer8(addr + 0, ((uint8_t *)&m_channel) + 0);
-		EEPROM_WriteBuffer8(addr + 8, ((uint8_t *)&m_channel) + 8);
+		SETTINGS_update(&g_eeprom.config.channel[chan], &m_channel, sizeof(t_channel));
 	}
 
 //	SETTINGS_save_vfo_indices();
@@ -545,49 +1094,47 @@ void SETTINGS_save_channel(const unsigned int channel, const unsigned int vfo, v
 
 void SETTINGS_save_chan_name(const unsigned int channel)
 {
-	const unsigned int    eeprom_offset = (unsigned int)(((uint8_t *)&g_eeprom.config.channel_name) - ((uint8_t *)&g_eeprom));
-	const unsigned int    eeprom_addr   = eeprom_offset + (channel * 16);
-	const t_channel_name *chan_name     = &g_eeprom.config.channel_name[channel];
+	const unsigned int eeprom_offset = (unsigned int)(((uint8_t *)&g_eeprom.config.channel_name) - ((uint8_t *)&g_eeprom));
+	const unsigned int eeprom_addr   = eeprom_offset + (channel * sizeof(t_channel_name));
 
 	if (!IS_USER_CHANNEL(channel))
 		return;
 
-	EEPROM_WriteBuffer8(eeprom_addr + 0, ((uint8_t *)chan_name) + 0);
-	EEPROM_WriteBuffer8(eeprom_addr + 8, ((uint8_t *)chan_name) + 8);
+	SETTINGS_write(eeprom_addr, sizeof(t_channel_name));
 }
 
 void SETTINGS_save_chan_attribs_name(const unsigned int channel, const vfo_info_t *p_vfo)
 {
-	const unsigned int eeprom_offset = (unsigned int)(((uint8_t *)&g_eeprom.config.channel_attributes) - ((uint8_t *)&g_eeprom));
-	const unsigned int index         = channel & ~7u;     // eeprom writes are always 8 bytes in length
-
 	if (!IS_USER_CHANNEL(channel) && !IS_FREQ_CHANNEL(channel))
 		return;
 
 	if (p_vfo != NULL)
 	{	// channel attributes
-		g_eeprom.config.channel_attributes[channel] = p_vfo->channel_attributes;
-		EEPROM_WriteBuffer8(eeprom_offset + index, &g_eeprom.config.channel_attributes[index]);
+		SETTINGS_update(&g_eeprom.config.channel_attributes[channel], &p_vfo->channel_attributes, sizeof(t_channel_attrib));
 	}
 	else
 	if (channel <= USER_CHANNEL_LAST)
 	{	// user channel
-		g_eeprom.config.channel_attributes[channel].attributes = 0xff;
-		EEPROM_WriteBuffer8(eeprom_offset + index, &g_eeprom.config.channel_attributes[index]);
+		t_channel_attrib attributes;
+		attributes.attributes = 0xff;
+		SETTINGS_update(&g_eeprom.config.channel_attributes[channel], &attributes, sizeof(t_channel_attrib));
 	}
 
+	RADIO_update_channel_bitmap(channel);
+
 	if (channel <= USER_CHANNEL_LAST)
 	{	// user channel
+		t_channel_name name;
 		if (p_vfo != NULL)
 		{
-			memset(&g_eeprom.config.channel_name[channel], 0, sizeof(g_eeprom.config.channel_name[channel]));
-			memcpy(g_eeprom.config.channel_name[channel].name, p_vfo->channel_name.name, sizeof(g_eeprom.config.channel_name[channel].name));
+			memset(&name, 0, sizeof(name));
+			memcpy(name.name, p_vfo->channel_name.name, sizeof(name.name));
 		}
 		else
 		{
-			memset(&g_eeprom.config.channel_name[channel], 0xff, sizeof(g_eeprom.config.channel_name[channel]));
+			memset(&name, 0xff, sizeof(name));
 		}
-		SETTINGS_save_chan_name(channel);
+		SETTINGS_update(&g_eeprom.config.channel_name[channel], &name, sizeof(name));
 	}
 }
 
@@ -603,6 +1150,10 @@ unsigned int SETTINGS_find_channel(const uint32_t frequency)
 		const uint32_t freq = g_eeprom.config.channel[chan].frequency;
 		if (g_eeprom.config.channel_attributes[chan].band > BAND7_470MHz || freq == 0 || freq == 0xffffffff)
 			continue;
+		#ifdef ENABLE_EEPROM_LAZY_LOAD
+			if (!SETTINGS_is_resident((chan * sizeof(t_channel)) / SETTINGS_LOAD_BLOCK))
+				continue;   // not read in yet, looked for again once everything has been
+		#endif
 		if (freq == frequency)
 			return chan;    // found it
 //		if (abs((int32_t)freq - (int32_t)frequency) < 300)
@@ -619,6 +1170,10 @@ uint32_t SETTINGS_fetch_channel_frequency(const int channel)
 	if (channel < 0 || channel > (int)USER_CHANNEL_LAST)
 		return 0;
 
+	#ifdef ENABLE_EEPROM_LAZY_LOAD
+		SETTINGS_load_channel(channel);
+	#endif
+
 	freq = g_eeprom.config.channel[channel].frequency;
 
 	if (g_eeprom.config.channel_attributes[channel].band > BAND7_470MHz || freq == 0 || freq == 0xffffffff)
@@ -635,7 +1190,12 @@ unsigned int SETTINGS_fetch_channel_step_setting(const int channel)
 		return 0;
 
 	if (channel <= USER_CHANNEL_LAST)
+	{
+		#ifdef ENABLE_EEPROM_LAZY_LOAD
+			SETTINGS_load_channel(channel);
+		#endif
 		step_setting = g_eeprom.config.channel[channel].step_setting;
+	}
 	else
 	if (channel <= FREQ_CHANNEL_LAST)
 		step_setting = g_eeprom.config.vfo_channel[(channel - FREQ_CHANNEL_FIRST) * 2].step_setting;
@@ -674,6 +1234,10 @@ void SETTINGS_fetch_channel_name(char *s, const int channel)
 	if (g_eeprom.config.channel_attributes[channel].band > BAND7_470MHz)
 		return;
 
+	#ifdef ENABLE_EEPROM_LAZY_LOAD
+		SETTINGS_load_channel(channel);
+	#endif
+
 	memcpy(s, &g_eeprom.config.channel_name[channel], 10);
 
 	for (i = 0; i < 10; i++)
@@ -693,6 +1257,10 @@ void SETTINGS_factory_reset(bool bIsAll)
 
 	memset(Template, 0xFF, sizeof(Template));
 
+	#ifdef ENABLE_VFO_JOURNAL
+		SETTINGS_stop_journal();
+	#endif
+
 	for (i = 0x0C80; i < 0x1E00; i += 8)
 	{
 		if (
@@ -711,7 +1279,7 @@ void SETTINGS_factory_reset(bool bIsAll)
 				))
 			)
 		{
-			EEPROM_WriteBuffer8(i, Template);
+			SETTINGS_update(((uint8_t *)&g_eeprom) + i, Template, sizeof(Template));
 		}
 	}
 
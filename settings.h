@@ -103,6 +103,7 @@ enum {
 	ACTION_OPT_ALARM,
 	ACTION_OPT_FM,
 	ACTION_OPT_TX_TONE,
+	ACTION_OPT_SPECTRUM,
 	ACTION_OPT_LEN
 };
 
@@ -257,6 +258,20 @@ typedef struct {
 	uint8_t      unused[6];
 } __attribute__((packed)) t_channel_name;
 
+// 8 bytes
+typedef struct {
+	uint8_t  seq;                            // sequence number
+	uint8_t  check;                          // ~(sum of the other 7 bytes)
+	uint16_t address;                        // eeprom address of the 4-byte value
+	uint32_t value;                          //
+} __attribute__((packed)) t_journal_record;
+
+// 32 bytes .. one eeprom page, so each journal record wears its own page
+typedef struct {
+	t_journal_record record;
+	uint8_t          unused[24];             // 0xff's
+} __attribute__((packed)) t_journal_page;
+
 // user configuration
 typedef struct {
 
@@ -346,7 +361,13 @@ typedef struct {
 		#ifdef ENABLE_PANADAPTER
 			struct {
 				uint8_t panadapter:1;                   // 1 = enable panadapter
-				uint8_t unused6a:7;                     // 0xff
+				uint8_t panadapter_trace_only:1;        // 0 = waterfall under the trace, 1 = just the trace (as erased)
+				#ifdef ENABLE_PANADAPTER_SPAN
+					uint8_t panadapter_span:3;          // PANADAPTER_SPAN_TABLE index, 7 = auto (as erased)
+					uint8_t panadapter_spacing:3;       // PANADAPTER_SPACING_TABLE index, 7 = auto (as erased)
+				#else
+					uint8_t unused6a:6;                 // 0xff
+				#endif
 			};
 		#else
 			uint8_t     unused6a;                       // 0xff
@@ -463,7 +484,10 @@ typedef struct {
 	t_channel_name channel_name[USER_CHANNEL_LAST - USER_CHANNEL_FIRST + 1];
 
 	// 0x1BD0
-	uint8_t        unused13[16 * 3];      // 0xff's .. free to use
+	uint8_t        unused13[16];          // 0xff's .. free to use
+
+	// 0x1BE0
+	t_journal_page vfo_journal_a;         // 1of11 .. VFO/FM frequency journal page 0 (see settings.c), otherwise 0xff's
 
 	// 0x1C00
 	struct {
@@ -551,7 +575,11 @@ typedef struct {
 	uint8_t  dac_gain;                              //
 
 	// 0x1F90
-	uint8_t  unused3[16 * 7];                       // 0xff's
+	uint8_t  scan_settle_50us[7];                   // 1of11 .. measured RSSI settle time after a retune, per band, 0xff = not measured
+	uint8_t  unused3a[9];                           // 0xff's
+
+	// 0x1FA0
+	t_journal_page vfo_journal_b[3];                // 1of11 .. VFO/FM frequency journal pages 1 ~ 3 (see settings.c), otherwise 0xff's
 
 	// 0x2000
 
@@ -564,7 +592,7 @@ typedef struct {
 	t_config       config;            // radios user config
 
 	// 0x1D00
-	uint8_t        unused[16 * 16];   // does this belong to the config, or the calibration, or neither ?
+	uint8_t        scan_ignore[16 * 16];   // 1of11 .. scan ignore list (see freq_ignore.c), otherwise unused
 
 	// 0x1E00
 	t_calibration  calib;             // calibration settings .. we DO NOT pass this through aircopy, it's radio specific
@@ -615,6 +643,17 @@ typedef struct vfo_info_t
 extern t_eeprom g_eeprom;
 
 void SETTINGS_read_eeprom(void);
+#ifdef ENABLE_EEPROM_LAZY_LOAD
+	void SETTINGS_load(const unsigned int index, const unsigned int size);
+	void SETTINGS_load_channel(const unsigned int channel);
+	void SETTINGS_load_next(void);
+#endif
+#ifdef ENABLE_EEPROM_CACHE
+	void SETTINGS_flush(void);
+#endif
+#ifdef ENABLE_VFO_JOURNAL
+	void SETTINGS_stop_journal(void);
+#endif
 void SETTINGS_write_eeprom_config(void);
 void SETTINGS_write_eeprom_calib(void);
 
@@ -22,6 +22,7 @@
 #include "driver/keyboard.h"
 #include "driver/st7565.h"
 #include "misc.h"
+#include "scheduler.h"
 #include "settings.h"
 #include "ui/helper.h"
 #include "ui/inputbox.h"
@@ -44,11 +45,15 @@ static void Render(void)
 
 	ST7565_BlitStatusLine();
 	ST7565_BlitFullScreen();
+	#ifdef ENABLE_LCD_ASYNC_BLIT
+		ST7565_Flush();   // we're not in the main loop to send it
+	#endif
 }
 
 void UI_DisplayLock(void)
 {
 	unsigned int g_debounce_counter = 0;
+	uint32_t     tick               = SCHEDULER_ticks();
 //	bool         g_key_being_held   = false;
 	key_code_t   g_key_reading_0    = KEY_INVALID;
 //	key_code_t   g_key_reading_1;
@@ -61,11 +66,9 @@ void UI_DisplayLock(void)
 
 	while (1)
 	{
-		while (!g_next_time_slice) {}
-
-		// TODO: Original code doesn't do the below, but is needed for proper key debounce
-
-		g_next_time_slice = false;
+		// wait for the next 10ms tick
+		while (tick == SCHEDULER_ticks()) {}
+		tick = SCHEDULER_ticks();
 
 		Key = KEYBOARD_Poll();
 
@@ -129,7 +129,7 @@ void draw_bar(uint8_t *line, const int len, const int max_width)
 			const unsigned int txt_width = 7 * 3;                 // 3 text chars
 			const unsigned int bar_x     = 2 + txt_width + 4;     // X coord of bar graph
 			const unsigned int bar_width = LCD_WIDTH - 1 - bar_x;
-			const unsigned int secs      = g_tx_timer_tick_500ms / 2;
+			const unsigned int secs      = SCHEDULER_remaining(&g_tx_timer) / 100;
 			uint8_t           *p_line    = g_frame_buffer[line];
 			char               s[16];
 
@@ -421,13 +421,69 @@ void big_freq(const uint32_t frequency, const unsigned int x, const unsigned int
 		return n;
 	}
 
+	#ifdef ENABLE_PANADAPTER_WATERFALL
+		static void UI_DisplayMain_waterfall(const unsigned int line, const bool valid, const uint8_t min_rssi, const uint8_t span_rssi)
+		{	// the trace squashed into the top line, the last few sweeps scrolling down the two lines below it
+
+			// 4x4 ordered dither thresholds
+			static const uint8_t dither[4][4] = {
+				{ 0,  8,  2, 10},
+				{12,  4, 14,  6},
+				{ 3, 11,  1,  9},
+				{15,  7, 13,  5}
+			};
+
+			uint8_t     *top_line = g_frame_buffer[line];
+			unsigned int i;
+			unsigned int age;
+
+			// VFO frequency marker
+			top_line[PANADAPTER_BINS] = 0x15;
+
+			if (!valid)
+				return;
+
+			for (i = 0; i < ARRAY_SIZE(g_panadapter_rssi); i++)
+			{
+				unsigned int rssi = (g_panadapter_rssi[i] <= min_rssi) ? 0 : ((uint16_t)(g_panadapter_rssi[i] - min_rssi) * 7) / span_rssi;  // 0 ~ 7
+				if (rssi > 7)
+					rssi = 7;
+				top_line[i] |= bit_reverse_8((1u << (rssi + 1)) - 1);
+
+				#ifdef ENABLE_PANADAPTER_AVG_PEAK
+				{	// peak hold dot
+					unsigned int peak = (g_panadapter_peak_rssi[i] <= min_rssi) ? 0 : ((uint16_t)(g_panadapter_peak_rssi[i] - min_rssi) * 7) / span_rssi;
+					if (peak > 7)
+						peak = 7;
+					top_line[i] |= 0x80u >> peak;
+				}
+				#endif
+			}
+
+			// newest at the top .. the dither pattern goes with the sweep rather than the screen row,
+			// so a steady signal scrolls down rather than sparkling
+			for (age = 0; age < g_panadapter_waterfall_count; age++)
+			{
+				const unsigned int index = (g_panadapter_waterfall_newest + PANADAPTER_WATERFALL_LINES - age) % PANADAPTER_WATERFALL_LINES;
+				const uint8_t     *row   = g_panadapter_waterfall[index];
+				const uint8_t     *d     = dither[index % 4];
+				uint8_t           *dest  = g_frame_buffer[line + 1 + (age / 8)];
+				const uint8_t      pixel = 1u << (age % 8);
+
+				for (i = 0; i < ARRAY_SIZE(g_panadapter_rssi); i++)
+					if ((PAN_waterfall_level(row, i) * 16) > (d[i % 4] * PANADAPTER_WATERFALL_MAX))
+						dest[i] |= pixel;
+			}
+		}
+	#endif
+
 	void UI_DisplayMain_pan(const bool now)
 	{
 		const bool         valid     = (g_panadapter_cycles > 0 && !g_monitor_enabled && g_current_function != FUNCTION_TRANSMIT) ? true : false;
 		const unsigned int line      = (g_eeprom.config.setting.tx_vfo_num == 0) ? 4 : 0;
 		uint8_t           *base_line = g_frame_buffer[line + 2];
-		uint8_t            min_rssi;
-		uint8_t            span_rssi;
+		uint8_t            min_rssi  = 0;
+		uint8_t            span_rssi = 30;
 		unsigned int       i;
 
 		if (!g_eeprom.config.setting.panadapter        ||
@@ -451,12 +507,7 @@ void big_freq(const uint32_t frequency, const unsigned int x, const unsigned int
 		if (valid)
 		{
 			// auto vertical scale
-			min_rssi  = g_panadapter_min_rssi;
-			span_rssi = g_panadapter_max_rssi - min_rssi;
-			if (span_rssi < 30)
-				span_rssi = 30;
-			if (min_rssi > (255 - span_rssi))
-				min_rssi =  255 - span_rssi;
+			PAN_get_scale(&min_rssi, &span_rssi);
 
 			#if 0
 				{	// show the min/max RSSI values
@@ -479,20 +530,30 @@ void big_freq(const uint32_t frequency, const unsigned int x, const unsigned int
 			#endif
 		}
 
+		#ifdef ENABLE_PANADAPTER_WATERFALL
+			if (!g_eeprom.config.setting.panadapter_trace_only)
+			{
+				UI_DisplayMain_waterfall(line, valid, min_rssi, span_rssi);
+				if (now)
+					ST7565_BlitFullScreen();
+				return;
+			}
+		#endif
+
 		{	// draw top & bottom horizontal dotted line
-			const unsigned int top = PANADAPTER_BINS - (LCD_WIDTH * 2);
-			const unsigned int bot = PANADAPTER_BINS - (LCD_WIDTH * 0);
+			const int top = PANADAPTER_BINS - (LCD_WIDTH * 2);   // signed, it's behind base_line
+			const int bot = PANADAPTER_BINS - (LCD_WIDTH * 0);
 			for (i = 0; i < PANADAPTER_BINS; i += 4)
 			{
 				// top line
 				if (i <= 4)
 				{
-					base_line[top - i] |= 1u << 0;
-					base_line[top + i] |= 1u << 0;
+					base_line[top - (int)i] |= 1u << 0;
+					base_line[top + (int)i] |= 1u << 0;
 				}
 				// bottom line
-				base_line[bot - i] |= 1u << 6;
-				base_line[bot + i] |= 1u << 6;
+				base_line[bot - (int)i] |= 1u << 6;
+				base_line[bot + (int)i] |= 1u << 6;
 			}
 		}
 
@@ -511,7 +572,7 @@ void big_freq(const uint32_t frequency, const unsigned int x, const unsigned int
 					rssi = (rssi < ((-129 + 160) * 2)) ? 0 : rssi - ((-129 + 160) * 2);  // min of -129dBm (S3)
 					rssi = rssi >> 2;
 				#else
-					rssi = ((uint16_t)(rssi - min_rssi) * 22) / span_rssi;  // 0 ~ 22
+					rssi = (rssi <= min_rssi) ? 0 : ((uint16_t)(rssi - min_rssi) * 22) / span_rssi;  // 0 ~ 22
 				#endif
 
 				rssi += 2;                  // offset from the bottom
@@ -521,9 +582,19 @@ void big_freq(const uint32_t frequency, const unsigned int x, const unsigned int
 				pixels = (1u << rssi) - 1;  // pixels
 				pixels &= 0xfffffffe;       // clear the bottom line
 
-				base_line[i - (LCD_WIDTH * 2)] |= bit_reverse_8(pixels >> 16);
-				base_line[i - (LCD_WIDTH * 1)] |= bit_reverse_8(pixels >>  8);
-				base_line[i - (LCD_WIDTH * 0)] |= bit_reverse_8(pixels >>  0);
+				#ifdef ENABLE_PANADAPTER_AVG_PEAK
+				{	// peak hold dot
+					unsigned int peak = (g_panadapter_peak_rssi[i] <= min_rssi) ? 0 : ((uint16_t)(g_panadapter_peak_rssi[i] - min_rssi) * 22) / span_rssi;
+					peak += 2;
+					if (peak > 24)
+						peak = 24;
+					pixels |= 1u << (peak - 1);
+				}
+				#endif
+
+				base_line[(int)i - (LCD_WIDTH * 2)] |= bit_reverse_8(pixels >> 16);
+				base_line[(int)i - (LCD_WIDTH * 1)] |= bit_reverse_8(pixels >>  8);
+				base_line[(int)i - (LCD_WIDTH * 0)] |= bit_reverse_8(pixels >>  0);
 			}
 		}
 
@@ -1085,7 +1156,7 @@ void UI_DisplayMain(void)
 	memset(g_frame_buffer, 0, sizeof(g_frame_buffer));
 
 	#if defined(ENABLE_UART)
-		if (g_serial_config_tick_500ms > 0)
+		if (SCHEDULER_running(&g_serial_config_timer))
 		{	// tell user the serial comms is in use
 			BACKLIGHT_turn_on(5);		// 5 seconds
 			UI_PrintString("UART", 0, LCD_WIDTH, 1, 8);
@@ -31,6 +31,9 @@
 #include "functions.h"
 #include "helper/battery.h"
 #include "misc.h"
+#ifdef ENABLE_PANADAPTER_SPAN
+	#include "panadapter.h"
+#endif
 #include "radio.h"
 #include "settings.h"
 #include "ui/helper.h"
@@ -98,6 +101,10 @@ const t_menu_item g_menu_list[] =
 #ifdef ENABLE_PANADAPTER
 	{"PANA",   VOICE_ID_INVALID,                       MENU_PANADAPTER            },
 #endif
+#ifdef ENABLE_PANADAPTER_SPAN
+	{"PANSPN", VOICE_ID_INVALID,                       MENU_PANADAPTER_SPAN       },
+	{"PANBIN", VOICE_ID_INVALID,                       MENU_PANADAPTER_BIN        },
+#endif
 #ifdef ENABLE_TX_AUDIO_BAR
 	{"Tx BAR", VOICE_ID_INVALID,                       MENU_TX_BAR                },
 #endif
@@ -179,6 +186,10 @@ const t_menu_item g_menu_list[] =
 	{"FR CAL",  VOICE_ID_INVALID,                      MENU_F_CALI                }, // reference xtal calibration
 #endif
 
+#ifdef ENABLE_SCAN_SETTLE_CAL
+	{"ScnCAL", VOICE_ID_INVALID,                       MENU_SCAN_CAL              }, // scan RSSI settle time calibration
+#endif
+
 	{"F LOCK", VOICE_ID_INVALID,                       MENU_FREQ_LOCK             }, // country/area specific
 	{"Tx 174", VOICE_ID_INVALID,                       MENU_174_TX                }, // was "200TX"
 	{"Tx 350", VOICE_ID_INVALID,                       MENU_350_TX                }, // was "350TX"
@@ -193,7 +204,7 @@ const t_menu_item g_menu_list[] =
 };
 
 // number of hidden menu items at the end of the list - KEEP THIS CORRECT !
-const unsigned int g_hidden_menu_count = 12;
+const unsigned int g_hidden_menu_count = 13;
 
 // ***************************************************************************************
 
@@ -231,6 +242,15 @@ const char g_sub_menu_off_on[2][4] =
 	"ON"
 };
 
+#ifdef ENABLE_PANADAPTER_WATERFALL
+	const char g_sub_menu_panadapter[3][6] =
+	{
+		"OFF",
+		"ON",
+		"WFALL"
+	};
+#endif
+
 const char g_sub_menu_bat_save[5][9] =
 {
 	"OFF",
@@ -376,7 +396,11 @@ const char g_sub_menu_bat_text[3][8] =
 };
 
 #ifdef ENABLE_SIDE_BUTT_MENU
+#ifdef ENABLE_SPECTRUM
+const char g_sub_menu_side_butt[10][16] =
+#else
 const char g_sub_menu_side_butt[9][16] =
+#endif
 //const char g_sub_menu_side_butt[10][16] =
 {
 	"NONE",
@@ -388,6 +412,9 @@ const char g_sub_menu_side_butt[9][16] =
 	"ALARM\non\\off",
 	"FM RADIO\non\\off",
 	"TX\nTONE",
+#ifdef ENABLE_SPECTRUM
+	"SPECTRUM",
+#endif
 //	"2nd PTT",
 };
 #endif
@@ -449,6 +476,10 @@ void UI_SortMenu(const bool hide_hidden)
 		hidden_menu_count--;
 	#endif
 
+	#ifndef ENABLE_SCAN_SETTLE_CAL
+		hidden_menu_count--;
+	#endif
+
 	g_menu_list_count = ARRAY_SIZE(g_menu_list);
 
 	// sort non-hidden entries at the beginning
@@ -795,7 +826,30 @@ void UI_DisplayMenu(void)
 
 		#ifdef ENABLE_PANADAPTER
 			case MENU_PANADAPTER:
-				strcpy(str, g_sub_menu_off_on[g_sub_menu_selection]);
+				#ifdef ENABLE_PANADAPTER_WATERFALL
+					strcpy(str, g_sub_menu_panadapter[g_sub_menu_selection]);
+				#else
+					strcpy(str, g_sub_menu_off_on[g_sub_menu_selection]);
+				#endif
+				break;
+		#endif
+
+		#ifdef ENABLE_PANADAPTER_SPAN
+			case MENU_PANADAPTER_SPAN:
+			case MENU_PANADAPTER_BIN:
+				if (g_sub_menu_selection == 0)
+				{
+					strcpy(str, "AUTO");
+				}
+				else
+				{	// kHz
+					const uint32_t freq = (g_menu_cursor == MENU_PANADAPTER_SPAN) ?
+						PANADAPTER_SPAN_TABLE[g_sub_menu_selection - 1] :
+						PANADAPTER_SPACING_TABLE[g_sub_menu_selection - 1];
+					sprintf(str, "%s%u.%02u", (g_menu_cursor == MENU_PANADAPTER_SPAN) ? "+-" : "", freq / 100, freq % 100);
+					NUMBER_trim_trailing_zeros(str);
+					strcat(str, "kHz");
+				}
 				break;
 		#endif
 
@@ -1340,6 +1394,19 @@ void UI_DisplayMenu(void)
 				break;
 		#endif
 
+		#ifdef ENABLE_SCAN_SETTLE_CAL
+			case MENU_SCAN_CAL:
+				{	// the measured settle time for each band, MENU to measure them all again
+					const unsigned int settle = g_eeprom.calib.scan_settle_50us[g_sub_menu_selection];
+					sprintf(str, "BAND %u\n", 1 + g_sub_menu_selection);
+					if (settle == 0xff)
+						strcat(str, "--");
+					else
+						sprintf(str + strlen(str), "%u.%02ums", (settle * 50) / 1000, ((settle * 50) % 1000) / 10);
+				}
+				break;
+		#endif
+
 		case MENU_BAT_CAL:
 		{
 			const uint16_t vol = (uint32_t)g_battery_voltage_average * g_eeprom.calib.battery[3] / g_sub_menu_selection;
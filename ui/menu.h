@@ -88,6 +88,10 @@ enum
 #ifdef ENABLE_PANADAPTER
 	MENU_PANADAPTER,
 #endif
+#ifdef ENABLE_PANADAPTER_SPAN
+	MENU_PANADAPTER_SPAN,
+	MENU_PANADAPTER_BIN,
+#endif
 #ifdef ENABLE_TX_AUDIO_BAR
 	MENU_TX_BAR,
 #endif
@@ -171,6 +175,10 @@ enum
 	MENU_F_CALI,       // 26MHz reference xtal calibration
 #endif
 
+#ifdef ENABLE_SCAN_SETTLE_CAL
+	MENU_SCAN_CAL,     // per band scan RSSI settle time calibration
+#endif
+
 	MENU_SCRAMBLER_EN, // scrambler enable/disable
 	MENU_FREQ_LOCK,    // lock to a selected region
 	MENU_350_EN,       // 350~400MHz enable/disable
@@ -192,6 +200,9 @@ extern const char         g_sub_menu_tx_power[4][5];
 extern const char         g_sub_menu_shift_dir[3][4];
 extern const char         g_sub_menu_bandwidth[2][7];
 extern const char         g_sub_menu_off_on[2][4];
+#ifdef ENABLE_PANADAPTER_WATERFALL
+	extern const char     g_sub_menu_panadapter[3][6];
+#endif
 extern const char         g_sub_menu_bat_save[5][9];
 extern const char         g_sub_menu_dual_watch[3][10];
 extern const char         g_sub_menu_cross_vfo[3][10];
@@ -220,7 +231,11 @@ extern const char         g_sub_menu_rx_tx[4][6];
 #endif
 extern const char         g_sub_menu_bat_text[3][8];
 #ifdef ENABLE_SIDE_BUTT_MENU
-	extern const char     g_sub_menu_side_butt[9][16];
+	#ifdef ENABLE_SPECTRUM
+		extern const char g_sub_menu_side_butt[10][16];
+	#else
+		extern const char g_sub_menu_side_butt[9][16];
+	#endif
 #endif
 
 extern bool               g_in_sub_menu;
@@ -0,0 +1,157 @@
+/* Copyright 2023 One of Eleven
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <string.h>
+
+#include "app/spectrum.h"
+#include "driver/st7565.h"
+#include "external/printf/printf.h"
+#include "misc.h"
+#include "ui/helper.h"
+#include "ui/inputbox.h"
+#include "ui/spectrum.h"
+#include "ui/ui.h"
+
+#define SPECTRUM_TRACE_TOP      16   // pixel rows, LCD lines 2 ~ 5
+#define SPECTRUM_TRACE_HEIGHT   32
+
+static void UI_spectrum_pixel(const unsigned int x, const unsigned int y)
+{
+	g_frame_buffer[y >> 3][x] ^= 1u << (y & 7u);
+}
+
+static void UI_spectrum_freq(char *str, const uint32_t freq)
+{	// MHz to 1kHz
+	sprintf(str, "%u.%03u", freq / 100000, (freq % 100000) / 100);
+}
+
+static void UI_spectrum_trace(void)
+{
+	const unsigned int bottom    = SPECTRUM_TRACE_TOP + SPECTRUM_TRACE_HEIGHT - 1;
+	uint8_t            min_rssi  = 255;
+	uint8_t            span_rssi = 0;
+	unsigned int       i;
+	unsigned int       y;
+
+	// auto vertical scale
+	for (i = 0; i < SPECTRUM_POINTS; i++)
+	{
+		if (min_rssi > g_spectrum_rssi[i])
+			min_rssi = g_spectrum_rssi[i];
+		if (span_rssi < g_spectrum_rssi[i])
+			span_rssi = g_spectrum_rssi[i];
+	}
+	span_rssi -= min_rssi;
+	if (span_rssi < 30)
+		span_rssi = 30;   // 15dB
+
+	// a bar per point
+	for (i = 0; i < SPECTRUM_POINTS; i++)
+	{
+		const unsigned int height = ((unsigned int)(g_spectrum_rssi[i] - min_rssi) * (SPECTRUM_TRACE_HEIGHT - 1)) / span_rssi;
+		for (y = bottom - height; y <= bottom; y++)
+			UI_spectrum_pixel(i, y);
+	}
+
+	// peak marker, a notch in the top
+	UI_spectrum_pixel(g_spectrum_peak, SPECTRUM_TRACE_TOP);
+	if (g_spectrum_peak > 0)
+		UI_spectrum_pixel(g_spectrum_peak - 1, SPECTRUM_TRACE_TOP);
+	if (g_spectrum_peak < (SPECTRUM_POINTS - 1))
+		UI_spectrum_pixel(g_spectrum_peak + 1, SPECTRUM_TRACE_TOP);
+}
+
+void UI_DisplaySpectrum(void)
+{
+	char         str[22];
+	unsigned int y;
+
+	if (g_current_display_screen != DISPLAY_SPECTRUM)
+		return;
+
+	// clear screen/display buffer
+	memset(g_frame_buffer, 0, sizeof(g_frame_buffer));
+
+	// **********************************
+	// marker frequency and level, or the frequency being entered
+
+	if (g_spectrum_edit != SPECTRUM_EDIT_NONE)
+	{
+		unsigned int i;
+		char        *p = str;
+
+		strcpy(p, (g_spectrum_edit == SPECTRUM_EDIT_START) ? "START " : "STOP  ");
+		p += strlen(p);
+		for (i = 0; i < ARRAY_SIZE(g_input_box); i++)
+		{
+			if (i == 3)
+				*p++ = '.';
+			*p++ = (i < g_input_box_index) ? '0' + g_input_box[i] : '-';
+		}
+		*p = 0;
+		UI_PrintStringSmall(str, 2, 0, 0);
+	}
+	else
+	{
+		const uint32_t freq = SPECTRUM_freq(g_spectrum_marker);
+
+		sprintf(str, "%u.%05u", freq / 100000, freq % 100000);
+		UI_PrintStringSmall(str, 2, 0, 0);
+
+		if (g_spectrum_valid)
+		{
+			sprintf(str, "%ddBm", ((int)g_spectrum_rssi[g_spectrum_marker] / 2) - 160);
+			UI_PrintStringSmall(str, LCD_WIDTH - 2 - (7 * strlen(str)), 0, 0);
+		}
+	}
+
+	// **********************************
+	// RX filter and sweep rate
+
+	{
+		const char *bw[] = {"25k", "12.5k", "6.25k"};
+		sprintf(str, "RBW %s%s", (g_spectrum_rbw == SPECTRUM_RBW_AUTO) ? "A " : "", bw[SPECTRUM_filter_bandwidth()]);
+		UI_PrintStringSmall(str, 2, 0, 1);
+	}
+
+	if (g_spectrum_sweeps_10 > 0)
+	{
+		sprintf(str, "%u.%u/s", g_spectrum_sweeps_10 / 10, g_spectrum_sweeps_10 % 10);
+		UI_PrintStringSmall(str, LCD_WIDTH - 2 - (7 * strlen(str)), 0, 1);
+	}
+
+	// **********************************
+	// the trace with a dotted marker line through it
+
+	if (g_spectrum_valid)
+		UI_spectrum_trace();
+
+	for (y = SPECTRUM_TRACE_TOP; y < (SPECTRUM_TRACE_TOP + SPECTRUM_TRACE_HEIGHT); y += 2)
+		UI_spectrum_pixel(g_spectrum_marker, y);
+
+	// **********************************
+	// start and stop frequencies
+
+	UI_spectrum_freq(str, g_spectrum_start);
+	UI_PrintStringSmall(str, 2, 0, 6);
+
+	UI_spectrum_freq(str, SPECTRUM_freq(SPECTRUM_POINTS - 1));
+	UI_PrintStringSmall(str, LCD_WIDTH - 2 - (7 * strlen(str)), 0, 6);
+
+	// **********************************
+
+	ST7565_BlitFullScreen();
+}
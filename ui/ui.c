@@ -31,6 +31,9 @@
 #include "ui/main.h"
 #include "ui/menu.h"
 #include "ui/search.h"
+#ifdef ENABLE_SPECTRUM
+	#include "ui/spectrum.h"
+#endif
 #include "ui/ui.h"
 
 gui_display_type_t g_current_display_screen;
@@ -69,6 +72,12 @@ void GUI_DisplayScreen(void)
 				break;
 		#endif
 
+		#ifdef ENABLE_SPECTRUM
+			case DISPLAY_SPECTRUM:
+				UI_DisplaySpectrum();
+				break;
+		#endif
+
 		default:
 			break;
 	}
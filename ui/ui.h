@@ -27,6 +27,7 @@ enum gui_display_type_e
 	DISPLAY_MENU,
 	DISPLAY_SEARCH,
 	DISPLAY_AIRCOPY,
+	DISPLAY_SPECTRUM,
 	DISPLAY_INVALID     // 0xff
 };
 typedef enum gui_display_type_e gui_display_type_t;